@@ -43,6 +43,7 @@ extern TIM_HandleTypeDef htim4;
 extern TIM_HandleTypeDef htim7;
 
 /* USER CODE BEGIN Private defines */
+extern TIM_HandleTypeDef htim17;
 
 /* USER CODE END Private defines */
 
@@ -55,6 +56,7 @@ void MX_TIM7_Init(void);
 void HAL_TIM_MspPostInit(TIM_HandleTypeDef *htim);
 
 /* USER CODE BEGIN Prototypes */
+void MX_TIM17_Init(void);
 
 /* USER CODE END Prototypes */
 
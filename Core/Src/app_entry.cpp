@@ -5,6 +5,9 @@
 #include "SEGGER_RTT.h"
 #include "App_PidConfig.h"
 #include "LineFollower_Interface.h"
+#include "BlackBox_Interface.h"
+#include "MemWatch.h"
+#include "SpeedProfile.hpp"
 #include "Prompt.hpp"
 #include "u8g2.h"
 #include "ui.h"
@@ -54,6 +57,10 @@ void App_Start(void) {
         UI_Button_Update();
 
         App_Serial_Loop();
+        App_GyroBias_Poll();
+        BlackBox_Poll();
+        MemWatch_Poll(HAL_GetTick());
+        SpeedProfile_Poll();
 
         // 绘制 UI
         UI_Render();
@@ -35,6 +35,9 @@
 #include "IMU.h"
 #include "OLED.h"
 #include "u8g2.h"
+#include "CrashLog.h"
+#include "Boot.h"
+#include "MemWatch.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -57,6 +60,7 @@ u8g2_t u8g2;
 /* USER CODE BEGIN PV */
 float times = 0.01f;
 float User_YPR[3];
+float User_Rates[3];
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -79,7 +83,7 @@ int main(void)
 {
 
   /* USER CODE BEGIN 1 */
-
+  MemWatch_PaintStack(); // 栈水位统计，必须在任何深调用之前
   /* USER CODE END 1 */
 
   /* MPU Configuration--------------------------------------------------------*/
@@ -126,24 +130,12 @@ int main(void)
   MX_TIM7_Init();
   MX_SPI6_Init();
   /* USER CODE BEGIN 2 */
+  MX_TIM17_Init();
   SEGGER_RTT_Init();
 
-  // 1. 初始化寻线控制 (电机, 定时器)
-  LineFollower_Init();
-
-  // 2. 加载 Flash 参数并覆盖默认 PID
-  App_Pid_Init();
-
-  // 3. 启动串口 DMA 接收
-  App_Serial_Init();
-
-  // 4. 初始化陀螺仪
-  IMU_init();
-
-  HAL_TIM_Base_Start_IT(&htim7);
-
-  u8g2Init(&u8g2);
-  u8g2_SetFont(&u8g2,u8g2_font_6x12_tf);
+  // 寻线控制、Flash 参数、串口、陀螺仪、OLED 分步交错初始化，最后启动 TIM7/TIM17
+  // 各阶段 DWT 计时走 RTT，阶段表见 Drivers/BSP/Src/Boot.cpp
+  Boot_Run();
 
   App_Start(); // 启动 C++ 应用程序入口
   /* USER CODE END 2 */
@@ -226,9 +218,20 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
 {
   if (htim->Instance == TIM7) {
     IMU_getYawPitchRoll(User_YPR);
+    IMU_getRates(User_Rates);
     LineFollower_OnTimer();
+  } else if (htim->Instance == TIM17) {
+    LineFollower_OnSpeedLoop();
+#if MEMWATCH_ISR_SAMPLE
+    MemWatch_SampleIsr();
+#endif
   }
 }
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+  LineFollower_OnEdge(GPIO_Pin);
+}
 /* USER CODE END 4 */
 
  /* MPU Configuration */
@@ -280,10 +283,8 @@ void Error_Handler(void)
 {
   /* USER CODE BEGIN Error_Handler_Debug */
   /* User can add his own implementation to report the HAL error return state */
-  __disable_irq();
-  while (1)
-  {
-  }
+  /* 保存调用者地址和栈后软复位，现场下次上电写进 W25Q64 */
+  CrashLog_Error((uint32_t)__builtin_return_address(0));
   /* USER CODE END Error_Handler_Debug */
 }
 #ifdef USE_FULL_ASSERT
@@ -30,6 +30,19 @@
  */
 static uint8_t *__sbrk_heap_end = NULL;
 
+/**
+ * 堆增长统计 (MemWatch.cpp 的 "MEM" 报告读取)
+ * newlib-nano 基本不把内存还给 _sbrk，当前堆顶即历史峰值
+ */
+uint32_t sbrk_calls = 0;
+uint32_t sbrk_fails = 0;
+
+uint8_t *sbrk_break(void)
+{
+  extern uint8_t _end; /* Symbol defined in the linker script */
+  return (NULL == __sbrk_heap_end) ? &_end : __sbrk_heap_end;
+}
+
 /**
  * @brief _sbrk() allocates memory to the newlib heap and is used by malloc
  *        and others from the C library
@@ -66,9 +79,12 @@ void *_sbrk(ptrdiff_t incr)
     __sbrk_heap_end = &_end;
   }
 
+  sbrk_calls++;
+
   /* Protect heap from growing into the reserved MSP stack */
   if (__sbrk_heap_end + incr > max_heap)
   {
+    sbrk_fails++;
     errno = ENOMEM;
     return (void *)-1;
   }
@@ -518,4 +518,28 @@ void HAL_TIM_Base_MspDeInit(TIM_HandleTypeDef* tim_baseHandle)
 
 /* USER CODE BEGIN 1 */
 
+TIM_HandleTypeDef htim17;
+
+/* TIM17: 1kHz 轮速内环节拍 (APB2 定时器时钟 240MHz / 240 / 1000) */
+void MX_TIM17_Init(void)
+{
+  __HAL_RCC_TIM17_CLK_ENABLE();
+
+  htim17.Instance = TIM17;
+  htim17.Init.Prescaler = 239;
+  htim17.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim17.Init.Period = 999;
+  htim17.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  htim17.Init.RepetitionCounter = 0;
+  htim17.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+  if (HAL_TIM_Base_Init(&htim17) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  /* 抢占优先级 0：高于 TIM7 / 传感器 EXTI (1)，外环跑到一半也能按时刷新占空比 */
+  HAL_NVIC_SetPriority(TIM17_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(TIM17_IRQn);
+}
+
 /* USER CODE END 1 */
@@ -14,6 +14,10 @@
 #include "IMU.h"
 #include "inv_imu_driver.h"
 #include <math.h> //  math.h ֧ sqrtf, atan2f, asinf
+#include "fast_math.h"
+#include "attitude_filter.h"
+#include "gyro_bias.h"
+#include "Boot.h"
 
 #include "SEGGER_RTT.h"
 #include "stm32h7xx_hal.h"
@@ -23,19 +27,27 @@
 
 /* ٶȣ򱱷ļٶڼٶȼƵķ *//* ٶȣɶļٶڼٶȼƵķ */
 xyz_f_t north,west;
-volatile float exInt, eyInt, ezInt;  // 
-volatile float q0, q1, q2, q3; // ȫԪ
+// ̬˲״̬ ( attitude_filter.h  ATT_FILTER ѡ)
+static AttitudeFilter s_att;
 
 volatile float yaw[5]= {0,0,0,0,0};  //ֵ
 int16_t Ax_offset=0,Ay_offset=0;
 float TTangles_gyro[7]; //ͮͮ˲Ƕ
 
-float Kp = 10.5f;
-
-
-void MadgwickAHRSupdate(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz);
 
 extern int bsp_IcmGetRawData(float accel_mg[3], float gyro_dps[3], float *temp_degc);
+extern int bsp_IcmGetMag(float mag_ut[3]);
+extern int setup_aux_mag(void);
+
+/* Ӳ/У׼m = (m_raw - offset) * scale
+ * Ű (Խ) IMU_magCalStart/Finish תȦ궨
+ * Ǽڲ (imu.mag_*)̣ϵ ParamStorage д */
+float mag_offset[3] = { IMU_MAG_OFFSET_X, IMU_MAG_OFFSET_Y, IMU_MAG_OFFSET_Z };
+float mag_scale[3]  = { IMU_MAG_SCALE_X, IMU_MAG_SCALE_Y, IMU_MAG_SCALE_Z };
+bool  mag_calibrated = false;       // 궨ɹŲں
+static float mag_min[3], mag_max[3];
+static float mag_cal[3];            // һУ׼Ĵų (uT)ûдʱ 0
+static volatile uint8_t mag_calibrating = 0;
 
 /**************************ʵֺ********************************************
 *ԭ:	   float invSqrt1(float x)
@@ -50,6 +62,8 @@ float invSqrt1(float x) {
 }
 
 extern int setup_imu(int use_ln, int accel_en, int gyro_en);
+extern int setup_imu_probe(void);
+extern int setup_imu_config(int use_ln, int accel_en, int gyro_en);
 /**************************ʵֺ********************************************
 *ԭ:	   void IMU_init(void)
 *:	  ʼIMU
@@ -66,19 +80,54 @@ void IMU_init(void)
 	if (0x00 == setup_imu(1,1,1))
 	{
 		// initialize quaternion
-		q0 = 1.0f;  //ʼԪ
-		q1 = 0.0f;
-		q2 = 0.0f;
-		q3 = 0.0f;
-		exInt = 0.0f; // float suffix
-		eyInt = 0.0f;
-		ezInt = 0.0f;
+		AttFilter_init(&s_att); //ʼԪ, 
+		setup_aux_mag();         //ⲿƣûʱ̬˻ 6 
         HAL_Delay(100);
 		return;
 	}
 	RTT_Log("IMU ERROR!!\r\n");
 }
 
+/**************************ʵֺ********************************************
+*ԭ:	   int IMU_initStep(void)
+*:	  IMU_init ķֲ汾 (Լ Boot.h)
+			  ϵ 3msWHOAMI Լ 50msú 100ms ȶʱ
+			  Էֵصյ
+
+BOOT_DONE / BOOT_FAIL /  ms ٵ
+*******************************************************************************/
+int IMU_initStep(void)
+{
+	static uint8_t stage = 0;
+	static uint8_t tries = 0;
+	int rc;
+
+	switch (stage)
+	{
+	case 0:                                 //ȹȶ
+		stage = 1;
+		return 3;
+	case 1:
+		rc = setup_imu_probe();
+		if (rc == 1 && ++tries < 7) return 50;  //WHOAMI ԣ50ms ٶ
+		if (rc != 0 || setup_imu_config(1,1,1) != 0)
+		{
+			RTT_Log("IMU ERROR!!\r\n");
+			stage = 3;
+			return BOOT_FAIL;
+		}
+		AttFilter_init(&s_att);             //ʼԪ, 
+		setup_aux_mag();                    //ⲿƣûʱ̬˻ 6 
+		stage = 2;
+		return 100;
+	case 2:
+		stage = 3;
+		return BOOT_DONE;
+	default:
+		return BOOT_DONE;
+	}
+}
+
 static double Gyro_fill[3][300];
 static double Gyro_total[3];
 static double sqrGyro_total[3];
@@ -168,11 +217,9 @@ void IMU_getValues(float * values) {
 		gyro_offset[0] = avgResult_gyro[0];
 		gyro_offset[1] = avgResult_gyro[1];
 		gyro_offset[2] = avgResult_gyro[2];
-		exInt = 0;
-		eyInt = 0;
-		ezInt = 0;
+		GyroBias_learn(accgyroval[6], avgResult_gyro); //ǰоƬ¶ѧƫ-¶ȱ
 		CalCount = 0;
-        Kp = 0.5f;
+		AttFilter_settle(&s_att); //ƫѸ£, ̬
 	}
 	else if (CalCount < 100)
 	{
@@ -181,9 +228,34 @@ void IMU_getValues(float * values) {
     values[0] =  accgyroval[0];
     values[1] =  accgyroval[1];
     values[2] =  accgyroval[2];
-	values[3] =  accgyroval[3] - gyro_offset[0];
-	values[4] =  accgyroval[4] - gyro_offset[1];
-	values[5] =  accgyroval[5] - gyro_offset[2];
+	// ƫоƬ¶Ȳǿյ (״ϵδֹ) ʱ˻һξֹ궨ֵ
+	float bias[3] = { gyro_offset[0], gyro_offset[1], gyro_offset[2] };
+	GyroBias_lookup(accgyroval[6], bias);
+	values[3] =  accgyroval[3] - bias[0];
+	values[4] =  accgyroval[4] - bias[1];
+	values[5] =  accgyroval[5] - bias[2];
+
+	// ƣݲŸУ׼ֵû궨궨вں (δУ׼ĴųѺƫ)
+	float mag_raw[3];
+	if (bsp_IcmGetMag(mag_raw) == 0) {
+		for (int i = 0; i < 3; i++) {
+			if (mag_calibrating) {
+				if (mag_raw[i] < mag_min[i]) mag_min[i] = mag_raw[i];
+				if (mag_raw[i] > mag_max[i]) mag_max[i] = mag_raw[i];
+			}
+			mag_cal[i] = (mag_raw[i] - mag_offset[i]) * mag_scale[i];
+		}
+	}
+#if IMU_MAG_FUSION
+	int mag_use = mag_calibrated && !mag_calibrating;
+	values[6] = mag_use ? mag_cal[0] : 0.0f;
+	values[7] = mag_use ? mag_cal[1] : 0.0f;
+	values[8] = mag_use ? mag_cal[2] : 0.0f;
+#else
+	values[6] = 0.0f;
+	values[7] = 0.0f;
+	values[8] = 0.0f;
+#endif
 
 
 		//Ѿ̸ĳ 1000ÿ  32.8 Ӧ 1ÿ
@@ -195,51 +267,13 @@ void IMU_getValues(float * values) {
 *:	 AHRS Ԫ
  ǰĲֵ
 û
-* H7 Optimization: Replaced literals with float literals (2 -> 2.0f) to avoid double promotion.
+* ˲ mahony.c / madgwick.cֻ north/west ѡ
 *******************************************************************************/
-//#define Kp 0.5f   // proportional gain governs rate of convergence to accelerometer/magnetometer
-#define Ki 0.001f   // integral gain governs rate of convergence of gyroscope biases
+#define IMU_AHRS_DT  0.02f   // ̬ (TIM7 50Hz)
 
 void IMU_AHRSupdate(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz) {
-  float norm;
-  //float hx, hy, hz, bx, bz;
-  float vx, vy, vz;//, wx, wy, wz;
-  float ex, ey, ez,halfT;
-  float tempq0,tempq1,tempq2,tempq3;
-
-  // ȰЩõõֵ
-  float q0q0 = q0*q0;
-  float q0q1 = q0*q1;
-  float q0q2 = q0*q2;
-  float q0q3 = q0*q3;
-  float q1q1 = q1*q1;
-  float q1q2 = q1*q2;
-  float q1q3 = q1*q3;
-  float q2q2 = q2*q2;
-  float q2q3 = q2*q3;
-  float q3q3 = q3*q3;
-
-  halfT =  0.01f;
-
-  // Normalise accelerometer measurement
-  norm = invSqrt1(ax*ax + ay*ay + az*az);
-  ax = ax * norm;
-  ay = ay * norm;
-  az = az * norm;
-  //ѼӼƵάתɵλ
-
-  // Normalise magnetometer measurement
-  norm = invSqrt1(mx*mx + my*my + mz*mz);
-  mx = mx * norm;
-  my = my * norm;
-  mz = mz * norm;
-
-  // estimated direction of gravity and flux (v and w)
-  // Optimization: Added 'f' suffix to constants to enforce Single Precision FPU instructions
-  vx = 2.0f*(q1q3 - q0q2);
-  vy = 2.0f*(q0q1 + q2q3);
-  vz = q0q0 - q1q1 - q2q2 + q3q3;
-
+  // north/west ñθǰ̬ (ԭʵһ)
+  const float q0 = s_att.q[0], q1 = s_att.q[1], q2 = s_att.q[2], q3 = s_att.q[3];
   /* ٶȣ򱱷ļٶڼٶȼX */
 	north.x = 1.0f - 2.0f*(q3*q3 + q2*q2);
 	/* ٶȣ򱱷ļٶڼٶȼY */
@@ -253,35 +287,7 @@ void IMU_AHRSupdate(float gx, float gy, float gz, float ax, float ay, float az,
 	/* ٶȣɶļٶڼٶȼZ */
 	west.z = 2.0f* (-q0*q1 + q2*q3);
 
-  // error is sum of cross product between reference direction of fields and direction measured by sensors
-  ex = (ay*vz - az*vy);// + (my*wz - mz*wy);
-  ey = (az*vx - ax*vz);// + (mz*wx - mx*wz);
-  ez = (ax*vy - ay*vx);// + (mx*wy - my*wx);
-
-if(ex != 0.0f && ey != 0.0f && ez != 0.0f){
-  exInt = exInt + ex * Ki * halfT;
-  eyInt = eyInt + ey * Ki * halfT;
-  ezInt = ezInt + ez * Ki * halfT;
-
-  // òPIƫ
-  gx = gx + Kp*ex + exInt;
-  gy = gy + Kp*ey + eyInt;
-  gz = gz + Kp*ez + ezInt;
-
-  }
-
-  // Ԫ΢ַ
-  tempq0 = q0 + (-q1*gx - q2*gy - q3*gz)*halfT;
-  tempq1 = q1 + (q0*gx + q2*gz - q3*gy)*halfT;
-  tempq2 = q2 + (q0*gy - q1*gz + q3*gx)*halfT;
-  tempq3 = q3 + (q0*gz + q1*gy - q2*gx)*halfT;
-
-  // Ԫ淶
-  norm = invSqrt1(tempq0*tempq0 + tempq1*tempq1 + tempq2*tempq2 + tempq3*tempq3);
-  q0 = tempq0 * norm;
-  q1 = tempq1 * norm;
-  q2 = tempq2 * norm;
-  q3 = tempq3 * norm;
+  AttFilter_update(&s_att, gx, gy, gz, ax, ay, az, mx, my, mz, IMU_AHRS_DT);
 }
 
 
@@ -306,10 +312,10 @@ void IMU_getQ(float * q) {
                  mygetqval[0], mygetqval[1], mygetqval[2],
                  mygetqval[6], mygetqval[7], mygetqval[8]);
 
-  q[0] = q0; //صǰֵ
-  q[1] = q1;
-  q[2] = q2;
-  q[3] = q3;
+  q[0] = s_att.q[0]; //صǰֵ
+  q[1] = s_att.q[1];
+  q[2] = s_att.q[2];
+  q[3] = s_att.q[3];
 }
 
 
@@ -318,8 +324,14 @@ void IMU_getQ(float * q) {
 *:	 Ԫ صǰ̬
  Ҫ̬ǵ׵ַ
 û
-* H7 Optimization: Used atan2f and asinf instead of double versions.
+* H7 Optimization: polynomial fast_atan2f/fast_asinf (fast_math.h); pitch/roll computed lazily.
 *******************************************************************************/
+static void IMU_pitchRollFromQ(const float * q, float * pr) {
+  const float RAD_TO_DEG = 180.0f / 3.1415926535f;
+  pr[0] = -fast_asinf(-2.0f * q[1] * q[3] + 2.0f * q[0] * q[2]) * RAD_TO_DEG; // pitch
+  pr[1] = fast_atan2f(2.0f * q[2] * q[3] + 2.0f * q[0] * q[1], -2.0f * q[1] * q[1] - 2.0f * q[2] * q[2] + 1.0f) * RAD_TO_DEG; // roll
+}
+
 void IMU_getYawPitchRoll(float * angles) {
   float q[4]; //Ԫ
   // volatile float gx=0.0, gy=0.0, gz=0.0; // unused variable
@@ -327,13 +339,101 @@ void IMU_getYawPitchRoll(float * angles) {
 
   const float RAD_TO_DEG = 180.0f / 3.1415926535f;
 
-  // ʹ atan2f  asinf  atan2  asin˫ת
-  angles[0] = -atan2f(2.0f * q[1] * q[2] + 2.0f * q[0] * q[3], -2.0f * q[2]*q[2] - 2.0f * q[3] * q[3] + 1.0f) * RAD_TO_DEG; // yaw
-  angles[1] = -asinf(-2.0f * q[1] * q[3] + 2.0f * q[0] * q[2]) * RAD_TO_DEG; // pitch
-  angles[2] = atan2f(2.0f * q[2] * q[3] + 2.0f * q[0] * q[1], -2.0f * q[1] * q[1] - 2.0f * q[2] * q[2] + 1.0f) * RAD_TO_DEG; // roll
+  // ʽƴ newlib  atan2f/asinf fast_math.h
+  angles[0] = -fast_atan2f(2.0f * q[1] * q[2] + 2.0f * q[0] * q[3], -2.0f * q[2]*q[2] - 2.0f * q[3] * q[3] + 1.0f) * RAD_TO_DEG; // yaw
+#if !IMU_LAZY_PITCH_ROLL
+  IMU_pitchRollFromQ(q, &angles[1]);
+#endif
  // if(angles[0]<0)angles[0]+=360.0f;  // -+180  ת0-360
 }
 
+/**************************ʵֺ********************************************
+*ԭ:	   void IMU_getPitchRoll(float * pr)
+*:	 ɵǰԪ / ()ֻʾȷǿƳ
+  pitch roll ׵ַ
+û
+*******************************************************************************/
+void IMU_getPitchRoll(float * pr) {
+  float q[4];
+  // Ԫ TIM7 ж£ʱжϱõθµĻֵ
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  q[0] = s_att.q[0];
+  q[1] = s_att.q[1];
+  q[2] = s_att.q[2];
+  q[3] = s_att.q[3];
+  __set_PRIMASK(primask);
+
+  IMU_pitchRollFromQ(q, pr);
+}
+
+ /**************************ʵֺ********************************************
+*ԭ:	   void IMU_getRates(float * rates)
+*:	 ر̬õǽٶ (Ѽƫλ /)
+  gx gy gz ׵ַ
+û
+*******************************************************************************/
+void IMU_getRates(float * rates) {
+  rates[0] = mygetqval[3];
+  rates[1] = mygetqval[4];
+  rates[2] = mygetqval[5];
+}
+
+ /**************************ʵֺ********************************************
+*ԭ:	   void IMU_magCalStart(void) / void IMU_magCalFinish(void)
+*:	 Ӳ/ű궨Start ԭתȦ (̬Ҫ)
+*            Finish ɸἫֵƫ (е)  (ƽ뾶 / 뾶) RTT
+*            д mag_calibratedɵ÷
+
+Finish  1 ʾӦã0 ʾ㱣ֵ
+*******************************************************************************/
+void IMU_magCalStart(void) {
+  for (int i = 0; i < 3; i++) {
+    mag_min[i] =  1e6f;
+    mag_max[i] = -1e6f;
+  }
+  mag_calibrating = 1;
+}
+
+int IMU_magCalFinish(void) {
+  float half[3], avg = 0.0f;
+
+  mag_calibrating = 0;
+  for (int i = 0; i < 3; i++) {
+    half[i] = 0.5f * (mag_max[i] - mag_min[i]);
+    avg += half[i] / 3.0f;
+  }
+  for (int i = 0; i < 3; i++) {
+    if (half[i] < IMU_MAG_CAL_MIN_SPAN) {
+      RTT_Log("[MAG] axis %d span %f uT too small, keep old calibration\r\n", i, 2.0f * half[i]);
+      return 0;
+    }
+  }
+
+  // ƫ/ TIM7 жʹã滻ʱж
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  for (int i = 0; i < 3; i++) {
+    mag_offset[i] = 0.5f * (mag_max[i] + mag_min[i]);
+    mag_scale[i] = avg / half[i];
+  }
+  mag_calibrated = true;
+  __set_PRIMASK(primask);
+
+  RTT_Log("[MAG] offset=%f,%f,%f scale=%f,%f,%f\r\n",
+          mag_offset[0], mag_offset[1], mag_offset[2], mag_scale[0], mag_scale[1], mag_scale[2]);
+  return 1;
+}
+
+int IMU_magCalActive(void) {
+  return mag_calibrating;
+}
+
+// ̬Բ (attitude_filter.h ȫ)дƸ˲
+void IMU_retuneFilter(void) {
+  AttFilter_retune(&s_att);
+}
+
  void IMU_TT_getgyro(float * zsjganda)
 {
 	zsjganda[0] = TTangles_gyro[0];
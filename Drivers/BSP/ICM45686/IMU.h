@@ -2,12 +2,38 @@
 #define __IMU_H
 
 #include <math.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #ifndef M_PI
 #define M_PI  3.1415926535f
 #endif
 
+// 1: IMU_getYawPitchRoll 只算 yaw，俯仰/横滚由 IMU_getPitchRoll 按需计算 (只用于显示)
+#ifndef IMU_LAZY_PITCH_ROLL
+#define IMU_LAZY_PITCH_ROLL 1
+#endif
+
+// 1: 校准后的外部磁力计 (AUX1 上的 AK09918) 参与姿态融合；没接磁力计或还没标定过 (imu.mag_ok = 0) 时退回 6 轴
+#ifndef IMU_MAG_FUSION
+#define IMU_MAG_FUSION 1
+#endif
+
+// 磁力计校准的出厂默认值 (uT)；"MAGCAL" 标定的结果写进参数表 imu.mag_* 并落盘，不用再改这里
+#ifndef IMU_MAG_OFFSET_X
+#define IMU_MAG_OFFSET_X 0.0f
+#define IMU_MAG_OFFSET_Y 0.0f
+#define IMU_MAG_OFFSET_Z 0.0f
+#define IMU_MAG_SCALE_X  1.0f
+#define IMU_MAG_SCALE_Y  1.0f
+#define IMU_MAG_SCALE_Z  1.0f
+#endif
+#define IMU_MAG_CAL_MIN_SPAN 10.0f   // 标定时每轴极差至少 (uT)，地磁约 50uT，转不够一圈时拒绝
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef struct
 {
     float x;
@@ -16,16 +42,29 @@ typedef struct
 } xyz_f_t;
 
 extern xyz_f_t north, west;
-extern volatile float q0, q1, q2, q3; // 全局四元数
 extern float gyro_offset[3];          // 陀螺仪零偏
+extern float mag_offset[3];           // 磁力计硬磁零偏 (uT)，参数表 imu.mag_ox..oz
+extern float mag_scale[3];            // 磁力计软磁缩放，参数表 imu.mag_sx..sz
+extern bool  mag_calibrated;          // 参数表 imu.mag_ok：标定过才参与融合
 
 // API
 void IMU_init(void);
+int  IMU_initStep(void);              // 开机调度器用的分步初始化 (返回值约定见 Boot.h)
 void IMU_getValues(float * values);
 void IMU_getYawPitchRoll(float * ypr);
+void IMU_getPitchRoll(float * pr);    // [pitch, roll] (°)，由当前四元数按需计算
+void IMU_getRates(float * rates);     // 去零偏的机体角速度 (°/s)，与最近一次 IMU_getYawPitchRoll 同一采样
 void IMU_TT_getgyro(float * zsjganda);
+void IMU_magCalStart(void);          // 开始磁力计硬磁/软磁标定 (期间磁场不参与融合)
+int  IMU_magCalFinish(void);         // 结束标定并应用结果，返回 1；极差不足时保留旧值，返回 0
+int  IMU_magCalActive(void);
+void IMU_retuneFilter(void);         // 参数表改了滤波器稳态增益后调用
 
 /* 核心解算函数，现在支持传入 dt 以适应不同频率 */
 void IMU_AHRSupdate(float gx, float gy, float gz, float ax, float ay, float az, float mx, float my, float mz);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,93 @@
+#ifndef __ATTITUDE_FILTER_H
+#define __ATTITUDE_FILTER_H
+
+/*
+ * 姿态滤波器公共接口
+ * 两种实现状态各自封装在结构体里，互不依赖全局变量；
+ * IMU.c 只通过 AttFilter_* 调用，编译期用 ATT_FILTER 选后端。
+ * 两个后端始终都参与编译，方便在同一固件 / 主机上对比。
+ *
+ * 输入单位：角速度 rad/s，加速度 / 磁场任意单位 (内部归一化)，dt 秒。
+ * 磁场全 0 时只用加速度修正 (航向纯陀螺积分)。
+ */
+
+#define ATT_FILTER_MAHONY    0
+#define ATT_FILTER_MADGWICK  1
+
+#ifndef ATT_FILTER
+#define ATT_FILTER  ATT_FILTER_MAHONY
+#endif
+
+/* Mahony：收敛期大 Kp 快速对齐重力，零偏标定完成后切稳态 Kp */
+#define MAHONY_KP_INIT     10.5f
+#define MAHONY_KP_SETTLED  0.5f
+#define MAHONY_KI          0.001f
+
+/* Madgwick：beta 同样分收敛期 / 稳态两档 */
+#define MADGWICK_BETA_INIT     2.5f
+#define MADGWICK_BETA_SETTLED  0.1f
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    float q[4];                 /* w x y z */
+    float exInt, eyInt, ezInt;  /* 误差积分 */
+    float kp;
+    float ki;
+    int   settled;              /* 已切稳态增益 */
+} MahonyFilter;
+
+typedef struct {
+    float q[4];                 /* w x y z */
+    float beta;
+    int   settled;
+} MadgwickFilter;
+
+/* 稳态增益，上电为上面的宏，参数表 (imu.kp / imu.ki / imu.beta) 运行时改写后调 *_retune 生效 */
+extern float mahony_kp_settled;
+extern float mahony_ki;
+extern float madgwick_beta_settled;
+
+void Mahony_init(MahonyFilter * f);
+void Mahony_settle(MahonyFilter * f);
+void Mahony_retune(MahonyFilter * f);
+void Mahony_update(MahonyFilter * f, float gx, float gy, float gz,
+                   float ax, float ay, float az, float mx, float my, float mz, float dt);
+
+void Madgwick_init(MadgwickFilter * f);
+void Madgwick_settle(MadgwickFilter * f);
+void Madgwick_retune(MadgwickFilter * f);
+void Madgwick_update(MadgwickFilter * f, float gx, float gy, float gz,
+                     float ax, float ay, float az, float mx, float my, float mz, float dt);
+
+#if ATT_FILTER == ATT_FILTER_MAHONY
+typedef MahonyFilter AttitudeFilter;
+static inline void AttFilter_init(AttitudeFilter * f)   { Mahony_init(f); }
+static inline void AttFilter_settle(AttitudeFilter * f) { Mahony_settle(f); }
+static inline void AttFilter_retune(AttitudeFilter * f) { Mahony_retune(f); }
+static inline void AttFilter_update(AttitudeFilter * f, float gx, float gy, float gz,
+                                    float ax, float ay, float az, float mx, float my, float mz, float dt)
+{
+    Mahony_update(f, gx, gy, gz, ax, ay, az, mx, my, mz, dt);
+}
+#elif ATT_FILTER == ATT_FILTER_MADGWICK
+typedef MadgwickFilter AttitudeFilter;
+static inline void AttFilter_init(AttitudeFilter * f)   { Madgwick_init(f); }
+static inline void AttFilter_settle(AttitudeFilter * f) { Madgwick_settle(f); }
+static inline void AttFilter_retune(AttitudeFilter * f) { Madgwick_retune(f); }
+static inline void AttFilter_update(AttitudeFilter * f, float gx, float gy, float gz,
+                                    float ax, float ay, float az, float mx, float my, float mz, float dt)
+{
+    Madgwick_update(f, gx, gy, gz, ax, ay, az, mx, my, mz, dt);
+}
+#else
+#error "unknown ATT_FILTER"
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef __FAST_MATH_H
+#define __FAST_MATH_H
+
+#include <math.h>
+
+/*
+ * 姿态解算用的快速反三角函数 (单精度，全部内联，无查表)
+ *
+ * fast_atan2f: 八分象限归约到 [0, 1] 后用 9 阶奇多项式 (Abramowitz & Stegun 4.4.49)
+ *              最大误差 1.2e-5 rad (0.00067°，含单精度舍入)，全平面一致；x = y = 0 返回 0
+ * fast_asinf : asin(x) = atan2(x, sqrt(1 - x^2))，误差同 fast_atan2f；|x| > 1 先钳位
+ *
+ * 开销：一次 VDIV + 五次乘加 (+ asin 一次 VSQRT)，不走 newlib 的双精度路径
+ */
+
+#define FAST_MATH_PI    3.14159265358979f
+#define FAST_MATH_PI_2  1.57079632679490f
+
+/* atan(a)，要求 0 <= a <= 1 */
+static inline float fast_atanf_unit(float a)
+{
+    const float z = a * a;
+    return a * (0.9998660f + z * (-0.3302995f + z * (0.1801410f + z * (-0.0851330f + z * 0.0208351f))));
+}
+
+static inline float fast_atan2f(float y, float x)
+{
+    const float ax = fabsf(x);
+    const float ay = fabsf(y);
+    const float mx = (ax > ay) ? ax : ay;
+    const float mn = (ax > ay) ? ay : ax;
+
+    if (mx == 0.0f) return 0.0f;
+
+    float r = fast_atanf_unit(mn / mx);
+    if (ay > ax) r = FAST_MATH_PI_2 - r;
+    if (x < 0.0f) r = FAST_MATH_PI - r;
+    return (y < 0.0f) ? -r : r;
+}
+
+static inline float fast_asinf(float x)
+{
+    if (x > 1.0f) x = 1.0f;
+    if (x < -1.0f) x = -1.0f;
+    return fast_atan2f(x, sqrtf((1.0f - x) * (1.0f + x)));
+}
+
+#endif
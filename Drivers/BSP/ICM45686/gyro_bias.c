@@ -0,0 +1,113 @@
+#include "gyro_bias.h"
+#include "stm32h7xx_hal.h"
+#include <string.h>
+
+static GyroBiasTable s_table;           // 学习结果 (导出/导入的就是它)
+static float s_dense[GB_BINS][3];       // 所有格都填好的查表用数据
+static int s_learned = 0;               // 学过的格数
+static volatile int s_dirty = 0;
+
+static int gb_bin(float temp_degc)
+{
+    int i = (int)((temp_degc - GB_T_MIN) / GB_T_STEP + 0.5f);
+    if (i < 0) i = 0;
+    if (i > GB_BINS - 1) i = GB_BINS - 1;
+    return i;
+}
+
+// 由学过的格重建稠密表：中间线性插值，两端用最近两格外推 (只有一格时取常数)
+static void gb_rebuild(void)
+{
+    int idx[GB_BINS];
+    int n = 0;
+
+    for (int i = 0; i < GB_BINS; i++)
+        if (s_table.count[i]) idx[n++] = i;
+    s_learned = n;
+    if (n == 0) return;
+
+    for (int i = 0; i < GB_BINS; i++) {
+        int a, b;
+        if (n == 1) {
+            a = b = idx[0];
+        } else if (i <= idx[0]) {
+            a = idx[0]; b = idx[1];
+        } else if (i >= idx[n - 1]) {
+            a = idx[n - 2]; b = idx[n - 1];
+        } else {
+            int k = 1;
+            while (idx[k] < i) k++;
+            a = idx[k - 1]; b = idx[k];
+        }
+        float t = (a == b) ? 0.0f : (float)(i - a) / (float)(b - a);
+        for (int ax = 0; ax < 3; ax++)
+            s_dense[i][ax] = s_table.bias[a][ax] + t * (s_table.bias[b][ax] - s_table.bias[a][ax]);
+    }
+}
+
+// 在 TIM7 中断 (静止检测) 里调用
+void GyroBias_learn(float temp_degc, const float bias[3])
+{
+    int i = gb_bin(temp_degc);
+    uint16_t n = s_table.count[i];
+
+    if (n < GB_LEARN_N_MAX) n++;
+    for (int ax = 0; ax < 3; ax++)
+        s_table.bias[i][ax] += (bias[ax] - s_table.bias[i][ax]) / (float)n;
+    s_table.count[i] = n;
+
+    gb_rebuild();
+    s_dirty = 1;
+}
+
+int GyroBias_lookup(float temp_degc, float bias[3])
+{
+    if (s_learned == 0) return 0;
+
+    float x = (temp_degc - GB_T_MIN) / GB_T_STEP;
+    if (x < 0.0f) x = 0.0f;
+    if (x > (float)(GB_BINS - 1)) x = (float)(GB_BINS - 1);
+    int i = (int)x;
+    if (i > GB_BINS - 2) i = GB_BINS - 2;
+    float t = x - (float)i;
+
+    for (int ax = 0; ax < 3; ax++)
+        bias[ax] = s_dense[i][ax] + t * (s_dense[i + 1][ax] - s_dense[i][ax]);
+    return 1;
+}
+
+// 主循环调用：拷贝时关中断，避免和中断里的学习交错
+void GyroBias_export(GyroBiasTable * t)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    s_table.magic = GB_MAGIC;
+    memcpy(t, &s_table, sizeof(*t));
+    s_dirty = 0;
+    __set_PRIMASK(primask);
+}
+
+int GyroBias_import(const GyroBiasTable * t)
+{
+    if (t->magic != GB_MAGIC) return 0;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memcpy(&s_table, t, sizeof(s_table));
+    for (int i = 0; i < GB_BINS; i++)
+        if (s_table.count[i] > GB_LEARN_N_MAX) s_table.count[i] = GB_LEARN_N_MAX;
+    gb_rebuild();
+    s_dirty = 0;
+    __set_PRIMASK(primask);
+    return 1;
+}
+
+int GyroBias_dirty(void)
+{
+    return s_dirty;
+}
+
+int GyroBias_learnedBins(void)
+{
+    return s_learned;
+}
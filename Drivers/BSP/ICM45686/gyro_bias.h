@@ -0,0 +1,39 @@
+#ifndef __GYRO_BIAS_H
+#define __GYRO_BIAS_H
+
+#include <stdint.h>
+
+/*
+ * 陀螺零偏-温度模型 (每轴一张分段线性表)
+ * 静止检测触发时把当前零偏按芯片温度学进对应温度格，学过的格之间线性插值、两端外推，
+ * 重建成一张稠密表；每次采样只做一次查表 + 插值。表可整体导出/导入 (W25Q64 持久化)。
+ */
+
+#define GB_T_MIN       15.0f   // 第 0 格温度 (°C)
+#define GB_T_STEP      2.5f    // 格宽 (°C)
+#define GB_BINS        16      // 覆盖 15 ~ 52.5°C
+#define GB_LEARN_N_MAX 16      // 每格滑动平均的最大样本数 (之后按 1/16 跟踪)
+#define GB_MAGIC       0x47423031u  // "GB01"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t magic;
+    uint16_t count[GB_BINS];       // 每格已学样本数，0 表示没学过
+    float    bias[GB_BINS][3];     // 每格零偏 (°/s)
+} GyroBiasTable;
+
+void GyroBias_learn(float temp_degc, const float bias[3]);
+int  GyroBias_lookup(float temp_degc, float bias[3]);   // 没有任何学过的格返回 0，bias 不变
+void GyroBias_export(GyroBiasTable * t);
+int  GyroBias_import(const GyroBiasTable * t);          // magic 不对返回 0 (保持空表)
+int  GyroBias_dirty(void);                              // 上次导出后又学过
+int  GyroBias_learnedBins(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
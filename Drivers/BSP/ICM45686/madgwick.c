@@ -0,0 +1,155 @@
+/*
+ * Madgwick 梯度下降姿态滤波 (S. Madgwick, 2010)
+ * 磁场全 0 时走 IMU (6 轴) 分支，否则走 MARG (9 轴) 分支。
+ * beta 与 Mahony 的 Kp 类似：收敛期取大值，零偏标定完成后切稳态值。
+ */
+#include "attitude_filter.h"
+#include <math.h>
+
+float madgwick_beta_settled = MADGWICK_BETA_SETTLED;
+
+static float madgwick_invSqrt(float x) {
+    if (x <= 0.0f) return 0.0f;
+    return 1.0f / sqrtf(x);
+}
+
+void Madgwick_init(MadgwickFilter * f)
+{
+    f->q[0] = 1.0f;
+    f->q[1] = 0.0f;
+    f->q[2] = 0.0f;
+    f->q[3] = 0.0f;
+    f->beta = MADGWICK_BETA_INIT;
+    f->settled = 0;
+}
+
+void Madgwick_settle(MadgwickFilter * f)
+{
+    f->beta = madgwick_beta_settled;
+    f->settled = 1;
+}
+
+void Madgwick_retune(MadgwickFilter * f)
+{
+    if (f->settled) f->beta = madgwick_beta_settled;
+}
+
+// 6 轴：梯度只含重力项
+static void madgwick_updateIMU(MadgwickFilter * f, float gx, float gy, float gz,
+                               float ax, float ay, float az, float dt)
+{
+    float q0 = f->q[0], q1 = f->q[1], q2 = f->q[2], q3 = f->q[3];
+    float recipNorm;
+    float s0, s1, s2, s3;
+    float qDot1, qDot2, qDot3, qDot4;
+
+    // 陀螺仪积分得到的四元数变化率
+    qDot1 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+    qDot2 = 0.5f * ( q0 * gx + q2 * gz - q3 * gy);
+    qDot3 = 0.5f * ( q0 * gy - q1 * gz + q3 * gx);
+    qDot4 = 0.5f * ( q0 * gz + q1 * gy - q2 * gx);
+
+    recipNorm = madgwick_invSqrt(ax * ax + ay * ay + az * az);
+    if (recipNorm != 0.0f) {
+        ax *= recipNorm;
+        ay *= recipNorm;
+        az *= recipNorm;
+
+        const float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1, _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+        const float _4q0 = 4.0f * q0, _4q1 = 4.0f * q1, _4q2 = 4.0f * q2;
+        const float _8q1 = 8.0f * q1, _8q2 = 8.0f * q2;
+        const float q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+
+        // 梯度下降方向
+        s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+        s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1 - _2q0 * ay - _4q1 + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+        s2 = 4.0f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+        s3 = 4.0f * q1q1 * q3 - _2q1 * ax + 4.0f * q2q2 * q3 - _2q2 * ay;
+        recipNorm = madgwick_invSqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+
+        qDot1 -= f->beta * s0 * recipNorm;
+        qDot2 -= f->beta * s1 * recipNorm;
+        qDot3 -= f->beta * s2 * recipNorm;
+        qDot4 -= f->beta * s3 * recipNorm;
+    }
+
+    q0 += qDot1 * dt;
+    q1 += qDot2 * dt;
+    q2 += qDot3 * dt;
+    q3 += qDot4 * dt;
+
+    recipNorm = madgwick_invSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    f->q[0] = q0 * recipNorm;
+    f->q[1] = q1 * recipNorm;
+    f->q[2] = q2 * recipNorm;
+    f->q[3] = q3 * recipNorm;
+}
+
+void Madgwick_update(MadgwickFilter * f, float gx, float gy, float gz,
+                     float ax, float ay, float az, float mx, float my, float mz, float dt)
+{
+    if (mx == 0.0f && my == 0.0f && mz == 0.0f) {
+        madgwick_updateIMU(f, gx, gy, gz, ax, ay, az, dt);
+        return;
+    }
+
+    float q0 = f->q[0], q1 = f->q[1], q2 = f->q[2], q3 = f->q[3];
+    float recipNorm;
+    float s0, s1, s2, s3;
+    float qDot1, qDot2, qDot3, qDot4;
+
+    qDot1 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+    qDot2 = 0.5f * ( q0 * gx + q2 * gz - q3 * gy);
+    qDot3 = 0.5f * ( q0 * gy - q1 * gz + q3 * gx);
+    qDot4 = 0.5f * ( q0 * gz + q1 * gy - q2 * gx);
+
+    recipNorm = madgwick_invSqrt(ax * ax + ay * ay + az * az);
+    if (recipNorm != 0.0f) {
+        ax *= recipNorm;
+        ay *= recipNorm;
+        az *= recipNorm;
+
+        recipNorm = madgwick_invSqrt(mx * mx + my * my + mz * mz);
+        mx *= recipNorm;
+        my *= recipNorm;
+        mz *= recipNorm;
+
+        const float _2q0mx = 2.0f * q0 * mx, _2q0my = 2.0f * q0 * my, _2q0mz = 2.0f * q0 * mz;
+        const float _2q1mx = 2.0f * q1 * mx;
+        const float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1, _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+        const float _2q0q2 = 2.0f * q0 * q2, _2q2q3 = 2.0f * q2 * q3;
+        const float q0q0 = q0 * q0, q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3;
+        const float q1q1 = q1 * q1, q1q2 = q1 * q2, q1q3 = q1 * q3;
+        const float q2q2 = q2 * q2, q2q3 = q2 * q3, q3q3 = q3 * q3;
+
+        // 地磁参考方向 (只保留水平分量 bx 和垂直分量 bz)
+        const float hx = mx * q0q0 - _2q0my * q3 + _2q0mz * q2 + mx * q1q1 + _2q1 * my * q2 + _2q1 * mz * q3 - mx * q2q2 - mx * q3q3;
+        const float hy = _2q0mx * q3 + my * q0q0 - _2q0mz * q1 + _2q1mx * q2 - my * q1q1 + my * q2q2 + _2q2 * mz * q3 - my * q3q3;
+        const float _2bx = sqrtf(hx * hx + hy * hy);
+        const float _2bz = -_2q0mx * q2 + _2q0my * q1 + mz * q0q0 + _2q1mx * q3 - mz * q1q1 + _2q2 * my * q3 - mz * q2q2 + mz * q3q3;
+        const float _4bx = 2.0f * _2bx;
+        const float _4bz = 2.0f * _2bz;
+
+        s0 = -_2q2 * (2.0f * q1q3 - _2q0q2 - ax) + _2q1 * (2.0f * q0q1 + _2q2q3 - ay) - _2bz * q2 * (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) + (-_2bx * q3 + _2bz * q1) * (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) + _2bx * q2 * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
+        s1 = _2q3 * (2.0f * q1q3 - _2q0q2 - ax) + _2q0 * (2.0f * q0q1 + _2q2q3 - ay) - 4.0f * q1 * (1.0f - 2.0f * q1q1 - 2.0f * q2q2 - az) + _2bz * q3 * (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) + (_2bx * q2 + _2bz * q0) * (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) + (_2bx * q3 - _4bz * q1) * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
+        s2 = -_2q0 * (2.0f * q1q3 - _2q0q2 - ax) + _2q3 * (2.0f * q0q1 + _2q2q3 - ay) - 4.0f * q2 * (1.0f - 2.0f * q1q1 - 2.0f * q2q2 - az) + (-_4bx * q2 - _2bz * q0) * (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) + (_2bx * q1 + _2bz * q3) * (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) + (_2bx * q0 - _4bz * q2) * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
+        s3 = _2q1 * (2.0f * q1q3 - _2q0q2 - ax) + _2q2 * (2.0f * q0q1 + _2q2q3 - ay) + (-_4bx * q3 + _2bz * q1) * (_2bx * (0.5f - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - mx) + (-_2bx * q0 + _2bz * q2) * (_2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - my) + _2bx * q1 * (_2bx * (q0q2 + q1q3) + _2bz * (0.5f - q1q1 - q2q2) - mz);
+        recipNorm = madgwick_invSqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+
+        qDot1 -= f->beta * s0 * recipNorm;
+        qDot2 -= f->beta * s1 * recipNorm;
+        qDot3 -= f->beta * s2 * recipNorm;
+        qDot4 -= f->beta * s3 * recipNorm;
+    }
+
+    q0 += qDot1 * dt;
+    q1 += qDot2 * dt;
+    q2 += qDot3 * dt;
+    q3 += qDot4 * dt;
+
+    recipNorm = madgwick_invSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    f->q[0] = q0 * recipNorm;
+    f->q[1] = q1 * recipNorm;
+    f->q[2] = q2 * recipNorm;
+    f->q[3] = q3 * recipNorm;
+}
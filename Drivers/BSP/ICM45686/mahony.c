@@ -0,0 +1,120 @@
+/*
+ * Mahony 互补滤波 (原 IMU.c 中 IMU_AHRSupdate 的实现，状态改为放在 MahonyFilter 里)
+ * 加速度修正俯仰/横滚；磁场非 0 时再加一项地磁误差修正航向，否则航向纯陀螺积分。
+ */
+#include "attitude_filter.h"
+#include <math.h>
+
+float mahony_kp_settled = MAHONY_KP_SETTLED;
+float mahony_ki = MAHONY_KI;
+
+static float mahony_invSqrt(float x) {
+    if (x <= 0.0f) return 0.0f;
+    return 1.0f / sqrtf(x);
+}
+
+void Mahony_init(MahonyFilter * f)
+{
+    f->q[0] = 1.0f;
+    f->q[1] = 0.0f;
+    f->q[2] = 0.0f;
+    f->q[3] = 0.0f;
+    f->exInt = 0.0f;
+    f->eyInt = 0.0f;
+    f->ezInt = 0.0f;
+    f->kp = MAHONY_KP_INIT;
+    f->ki = mahony_ki;
+    f->settled = 0;
+}
+
+// 陀螺零偏标定完成：清积分，切稳态增益
+void Mahony_settle(MahonyFilter * f)
+{
+    f->exInt = 0.0f;
+    f->eyInt = 0.0f;
+    f->ezInt = 0.0f;
+    f->kp = mahony_kp_settled;
+    f->settled = 1;
+}
+
+// 稳态增益被改：收敛期不动 Kp，等 settle 时再切
+void Mahony_retune(MahonyFilter * f)
+{
+    f->ki = mahony_ki;
+    if (f->settled) f->kp = mahony_kp_settled;
+}
+
+void Mahony_update(MahonyFilter * f, float gx, float gy, float gz,
+                   float ax, float ay, float az, float mx, float my, float mz, float dt)
+{
+    float norm;
+    float vx, vy, vz;
+    float ex, ey, ez;
+    float tempq0, tempq1, tempq2, tempq3;
+    const float halfT = 0.5f * dt;
+
+    float q0 = f->q[0], q1 = f->q[1], q2 = f->q[2], q3 = f->q[3];
+
+    // 把加计的三维向量转成单位向量
+    norm = mahony_invSqrt(ax*ax + ay*ay + az*az);
+    ax = ax * norm;
+    ay = ay * norm;
+    az = az * norm;
+
+    // 由当前四元数估计的重力方向
+    vx = 2.0f*(q1*q3 - q0*q2);
+    vy = 2.0f*(q0*q1 + q2*q3);
+    vz = q0*q0 - q1*q1 - q2*q2 + q3*q3;
+
+    // 测量重力与估计重力的叉积即姿态误差
+    ex = (ay*vz - az*vy);
+    ey = (az*vx - ax*vz);
+    ez = (ax*vy - ay*vx);
+
+    if (mx != 0.0f || my != 0.0f || mz != 0.0f) {
+        norm = mahony_invSqrt(mx*mx + my*my + mz*mz);
+        mx *= norm;
+        my *= norm;
+        mz *= norm;
+
+        // 磁场转到地理系，水平分量合成 bx (消除磁偏角)，垂直分量 bz
+        const float hx = 2.0f*mx*(0.5f - q2*q2 - q3*q3) + 2.0f*my*(q1*q2 - q0*q3) + 2.0f*mz*(q1*q3 + q0*q2);
+        const float hy = 2.0f*mx*(q1*q2 + q0*q3) + 2.0f*my*(0.5f - q1*q1 - q3*q3) + 2.0f*mz*(q2*q3 - q0*q1);
+        const float hz = 2.0f*mx*(q1*q3 - q0*q2) + 2.0f*my*(q2*q3 + q0*q1) + 2.0f*mz*(0.5f - q1*q1 - q2*q2);
+        const float bx = sqrtf(hx*hx + hy*hy);
+        const float bz = hz;
+
+        // 由当前四元数估计的地磁方向
+        const float wx = 2.0f*bx*(0.5f - q2*q2 - q3*q3) + 2.0f*bz*(q1*q3 - q0*q2);
+        const float wy = 2.0f*bx*(q1*q2 - q0*q3) + 2.0f*bz*(q0*q1 + q2*q3);
+        const float wz = 2.0f*bx*(q0*q2 + q1*q3) + 2.0f*bz*(0.5f - q1*q1 - q2*q2);
+
+        ex += (my*wz - mz*wy);
+        ey += (mz*wx - mx*wz);
+        ez += (mx*wy - my*wx);
+    }
+
+    if (ex != 0.0f && ey != 0.0f && ez != 0.0f) {
+        f->exInt += ex * f->ki * halfT;
+        f->eyInt += ey * f->ki * halfT;
+        f->ezInt += ez * f->ki * halfT;
+
+        // 用叉积误差来做PI修正陀螺零偏
+        gx = gx + f->kp*ex + f->exInt;
+        gy = gy + f->kp*ey + f->eyInt;
+        gz = gz + f->kp*ez + f->ezInt;
+    }
+
+    // 四元数微分方程
+    tempq0 = q0 + (-q1*gx - q2*gy - q3*gz)*halfT;
+    tempq1 = q1 + (q0*gx + q2*gz - q3*gy)*halfT;
+    tempq2 = q2 + (q0*gy - q1*gz + q3*gx)*halfT;
+    tempq3 = q3 + (q0*gz + q1*gy - q2*gx)*halfT;
+
+    // 四元数规范化
+    norm = mahony_invSqrt(tempq0*tempq0 + tempq1*tempq1 + tempq2*tempq2 + tempq3*tempq3);
+    f->q[0] = tempq0 * norm;
+    f->q[1] = tempq1 * norm;
+    f->q[2] = tempq2 * norm;
+    f->q[3] = tempq3 * norm;
+}
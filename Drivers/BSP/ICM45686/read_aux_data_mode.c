@@ -26,7 +26,7 @@ extern uint32_t SystemCoreClock;
 static void dwt_init(void)
 {
     DEMCR |= TRCENA;       /* 开启 Trace 功能 */
-    DWT_CYCCNT = 0;        /* 清除计数器 */
+    /* 不清零 CYCCNT：开机计时和传感器边沿时间戳也在用，延时只看差值 */
     DWT_CTRL |= CYCCNTENA; /* 开启周期计数器 */
 }
 
@@ -154,35 +154,36 @@ static int icm45686_write_regs(uint8_t reg, const uint8_t* buf, uint32_t len)
 	return 0;
 }
 
-/* Initializes IMU device and apply configuration. */
-int setup_imu(int use_ln, int accel_en, int gyro_en)
+/*
+ * 传输层初始化 (只做一次) + SPI 斜率配置 + 读一次 WHOAMI，不等待。
+ * 返回 0 WHOAMI 正确；1 不对 (稍后重试)；<0 总线错误。上电后需先留 3ms 再调用。
+ */
+int setup_imu_probe(void)
 {
-	int                      rc     = 0;
-	uint8_t                  whoami = 0;
-	inv_imu_int_pin_config_t int_pin_config;
-	inv_imu_int_state_t      int_config;
-	int retrycount = 0;
+	static int transport_ready = 0;
+	int      rc     = 0;
+	uint8_t  whoami = 0;
 
-    /* --- 新增: 初始化 DWT 计数器 --- */
-    dwt_init();
+	if (!transport_ready) {
+	    /* --- 新增: 初始化 DWT 计数器 --- */
+	    dwt_init();
 
-	imu_dev.transport.read_reg   = icm45686_read_regs;
-	imu_dev.transport.write_reg  = icm45686_write_regs;
-    /* --- 修改: 将 delay_us 改为 dwt_delay_us --- */
-	imu_dev.transport.sleep_us   = dwt_delay_us;
+		imu_dev.transport.read_reg   = icm45686_read_regs;
+		imu_dev.transport.write_reg  = icm45686_write_regs;
+	    /* --- 修改: 将 delay_us 改为 dwt_delay_us --- */
+		imu_dev.transport.sleep_us   = dwt_delay_us;
 
 #if defined(ICM_USE_HARD_SPI)
-	/* Init transport layer */
-	imu_dev.transport.serif_type = UI_SPI4;
+		/* Init transport layer */
+		imu_dev.transport.serif_type = UI_SPI4;
 
 #endif
 #if defined(ICM_USE_I2C)
-	imu_dev.transport.serif_type = UI_I2C;
-	IIC_Init();
+		imu_dev.transport.serif_type = UI_I2C;
+		IIC_Init();
 #endif
-	/* Wait 3 ms to ensure device is properly supplied  */
-    /* --- 修改: delay_ms(3) -> dwt_delay_ms(3) --- */
-	dwt_delay_ms(3);
+		transport_ready = 1;
+	}
 
 	/* In SPI, configure slew-rate to prevent bus corruption on DK-SMARTMOTION-REVG */
 	if (imu_dev.transport.serif_type == UI_SPI3 || imu_dev.transport.serif_type == UI_SPI4) {
@@ -197,10 +198,28 @@ int setup_imu(int use_ln, int accel_en, int gyro_en)
 	/* Check whoami */
 	rc |= inv_imu_get_who_am_i(&imu_dev, &whoami);
 	SI_CHECK_RC(rc);
-	while(whoami != INV_IMU_WHOAMI)
+	if (whoami != INV_IMU_WHOAMI) {
+		RTT_Log("Erroneous WHOAMI value: read 0x%02x, expected 0x%02x\r\n", whoami, INV_IMU_WHOAMI);
+		return 1;
+	}
+	return 0;
+}
+
+int setup_imu_config(int use_ln, int accel_en, int gyro_en);
+
+/* Initializes IMU device and apply configuration. */
+int setup_imu(int use_ln, int accel_en, int gyro_en)
+{
+	int rc;
+	int retrycount = 0;
+
+	dwt_init();
+	/* Wait 3 ms to ensure device is properly supplied  */
+    /* --- 修改: delay_ms(3) -> dwt_delay_ms(3) --- */
+	dwt_delay_ms(3);
+
+	while ((rc = setup_imu_probe()) == 1)
 	{
-		rc |= inv_imu_get_who_am_i(&imu_dev, &whoami);
-		SI_CHECK_RC(rc);
         /* --- 修改: delay_ms(50) -> dwt_delay_ms(50) --- */
 		dwt_delay_ms(50);
 		retrycount++;
@@ -209,13 +228,18 @@ int setup_imu(int use_ln, int accel_en, int gyro_en)
 			break;
 		}
 	}
-
-	if (whoami != INV_IMU_WHOAMI) {
-		RTT_Log("Erroneous WHOAMI value.");
-		RTT_Log("  - Read 0x%02x", whoami);
-		RTT_Log("  - Expected 0x%02x", INV_IMU_WHOAMI);
+	if (rc != 0)
 		return -1;
-	}
+
+	return setup_imu_config(use_ln, accel_en, gyro_en);
+}
+
+/* WHOAMI 通过后：软复位并配置中断、量程、ODR、带宽和电源模式 */
+int setup_imu_config(int use_ln, int accel_en, int gyro_en)
+{
+	int                      rc     = 0;
+	inv_imu_int_pin_config_t int_pin_config;
+	inv_imu_int_state_t      int_config;
 
 	rc |= inv_imu_soft_reset(&imu_dev);
 	SI_CHECK_RC(rc);
@@ -291,4 +315,183 @@ int bsp_IcmGetRawData(float accel_mg[3], float gyro_dps[3], float *temp_degc)
 	gyro_dps[2] = (float)((d.gyro_data[2] * 1000 /* dps */) / 32768.0);
 	*temp_degc  = (float)(25 + (d.temp_data / 128.0));
 	return 0;
-}
\ No newline at end of file
+}
+/* ===================== 外部磁力计 (AUX1 I2C 主机) ===================== */
+/*
+ * AK09918 挂在 ICM45686 的 AUX1 引脚上，由 IMU 内部 I2C 主机 (I2CM) 访问，MCU 只走 SPI6。
+ * I2CM 寄存器在 IPREG_TOP1 (间接寄存器)，inv_imu_read_reg/write_reg 会自动走 IREG 通道。
+ *
+ * 采样流水线：每个姿态周期先取上一次 I2CM 读回的数据，再立即发起下一次读，
+ * 不在中断里等 I2C 总线 (400kHz 下 9 字节约 250us)；代价是磁场比加速度/陀螺晚一个周期 (20ms)。
+ */
+#define AUX_MAG_I2C_ADDR       0x0C
+#define AK09918_WIA2           0x01
+#define AK09918_WIA2_ID        0x0C
+#define AK09918_ST1            0x10   /* ST1, HXL..HZH, TMPS, ST2 连续 9 字节 */
+#define AK09918_CNTL2          0x31
+#define AK09918_CNTL3          0x32
+#define AK09918_ST1_DRDY       0x01
+#define AK09918_ST2_HOFL       0x08
+#define AK09918_MODE_CONT_100HZ 0x08
+#define AK09918_SRST           0x01
+#define AK09918_UT_PER_LSB     0.15f
+#define AK09918_BURST_LEN      9
+
+#define I2CM_RW_READ           0
+#define I2CM_RW_WRITE          1
+#define IOC_AUX1_MODE_I2CM     1
+#define I2CM_TIMEOUT_US        2000
+
+/* 磁力计坐标轴 -> IMU 机体坐标轴 (AK09918 相对 ICM45686 的安装方向，按板子实际修改) */
+#define AUX_MAG_AXIS_X(m)      ( (m)[1])
+#define AUX_MAG_AXIS_Y(m)      ( (m)[0])
+#define AUX_MAG_AXIS_Z(m)      (-(m)[2])
+
+static int aux_mag_ok      = 0;  /* 探测成功并已进入连续测量模式 */
+static int aux_mag_pending = 0;  /* 已发起一次 I2CM 读，结果还没取 */
+
+/* 通道 0：设置从机地址/寄存器和一条命令 (endflag=1，只执行这一条) */
+static int i2cm_command(uint8_t reg, uint8_t r_w, uint8_t len)
+{
+	int rc = 0;
+	uint8_t profile[2] = { reg, AUX_MAG_I2C_ADDR }; /* DEV_PROFILE0 / DEV_PROFILE1 */
+	i2cm_command_0_t cmd;
+
+	cmd.burstlen_0 = len;
+	cmd.r_w_0      = r_w;
+	cmd.ch_sel_0   = 0;
+	cmd.endflag_0  = 1;
+	rc |= inv_imu_write_reg(&imu_dev, I2CM_DEV_PROFILE0, 2, profile);
+	rc |= inv_imu_write_reg(&imu_dev, I2CM_COMMAND_0, 1, (uint8_t *)&cmd);
+	return rc;
+}
+
+static int i2cm_go(void)
+{
+	i2cm_control_t ctrl;
+
+	memset(&ctrl, 0, sizeof(ctrl));
+	ctrl.i2cm_go         = 1;
+	ctrl.i2cm_speed      = 1; /* 400kHz */
+	ctrl.i2cm_restart_en = 1;
+	return inv_imu_write_reg(&imu_dev, I2CM_CONTROL, 1, (uint8_t *)&ctrl);
+}
+
+/* 返回 0 完成，1 仍在进行，<0 出错 */
+static int i2cm_poll(void)
+{
+	i2cm_status_t st;
+
+	if (inv_imu_read_reg(&imu_dev, I2CM_STATUS, 1, (uint8_t *)&st))
+		return INV_IMU_ERROR_TRANSPORT;
+	if (st.i2cm_timeout_err || st.i2cm_srst_err || st.i2cm_scl_err || st.i2cm_sda_err)
+		return INV_IMU_ERROR;
+	return st.i2cm_done ? 0 : 1;
+}
+
+static int i2cm_wait(void)
+{
+	uint32_t waited = 0;
+	int rc;
+
+	while ((rc = i2cm_poll()) == 1) {
+		if (waited >= I2CM_TIMEOUT_US)
+			return INV_IMU_ERROR_TIMEOUT;
+		dwt_delay_us(50);
+		waited += 50;
+	}
+	return rc;
+}
+
+static int aux_mag_write(uint8_t reg, uint8_t value)
+{
+	int rc = 0;
+
+	rc |= inv_imu_write_reg(&imu_dev, I2CM_WR_DATA0, 1, &value);
+	rc |= i2cm_command(reg, I2CM_RW_WRITE, 1);
+	rc |= i2cm_go();
+	SI_CHECK_RC(rc);
+	return i2cm_wait();
+}
+
+static int aux_mag_read(uint8_t reg, uint8_t * buf, uint8_t len)
+{
+	int rc = 0;
+
+	rc |= i2cm_command(reg, I2CM_RW_READ, len);
+	rc |= i2cm_go();
+	SI_CHECK_RC(rc);
+	rc = i2cm_wait();
+	SI_CHECK_RC(rc);
+	return inv_imu_read_reg(&imu_dev, I2CM_RD_DATA0, len, buf);
+}
+
+/* 打开 AUX1 的 I2C 主机模式，探测 AK09918 并设为 100Hz 连续测量；没接磁力计返回非 0，不影响 6 轴 */
+int setup_aux_mag(void)
+{
+	int rc = 0;
+	uint8_t id = 0;
+	ioc_pad_scenario_aux_ovrd_t pad;
+
+	aux_mag_ok = 0;
+	aux_mag_pending = 0;
+
+	memset(&pad, 0, sizeof(pad));
+	pad.aux1_enable_ovrd     = 1;
+	pad.aux1_enable_ovrd_val = 1;
+	pad.aux1_mode_ovrd       = 1;
+	pad.aux1_mode_ovrd_val   = IOC_AUX1_MODE_I2CM;
+	rc |= inv_imu_write_reg(&imu_dev, IOC_PAD_SCENARIO_AUX_OVRD, 1, (uint8_t *)&pad);
+	SI_CHECK_RC(rc);
+
+	rc = aux_mag_read(AK09918_WIA2, &id, 1);
+	if (rc || id != AK09918_WIA2_ID) {
+		RTT_Log("AUX mag not found (rc=%d id=0x%02x)\r\n", rc, id);
+		return -1;
+	}
+
+	rc |= aux_mag_write(AK09918_CNTL3, AK09918_SRST);
+	dwt_delay_ms(1);
+	rc |= aux_mag_write(AK09918_CNTL2, AK09918_MODE_CONT_100HZ);
+	SI_CHECK_RC(rc);
+
+	aux_mag_ok = 1;
+	return 0;
+}
+
+/*
+ * 取上一次 I2CM 读回的磁场 (uT，已转到 IMU 机体坐标) 并发起下一次读。
+ * 返回 0 表示 mag_ut 为新数据；非 0 表示本周期没有新数据 (未接 / 未就绪 / 磁饱和)，mag_ut 不变。
+ */
+int bsp_IcmGetMag(float mag_ut[3])
+{
+	uint8_t raw[AK09918_BURST_LEN];
+	int fresh = 0;
+	int rc;
+
+	if (!aux_mag_ok)
+		return -1;
+
+	if (aux_mag_pending) {
+		rc = i2cm_poll();
+		if (rc == 1)
+			return 1; /* 总线上一次还没跑完，下周期再取 */
+		aux_mag_pending = 0;
+		if (rc == 0 && inv_imu_read_reg(&imu_dev, I2CM_RD_DATA0, AK09918_BURST_LEN, raw) == 0
+		    && (raw[0] & AK09918_ST1_DRDY) && !(raw[8] & AK09918_ST2_HOFL)) {
+			float m[3];
+			m[0] = (float)(int16_t)(raw[1] | (raw[2] << 8)) * AK09918_UT_PER_LSB;
+			m[1] = (float)(int16_t)(raw[3] | (raw[4] << 8)) * AK09918_UT_PER_LSB;
+			m[2] = (float)(int16_t)(raw[5] | (raw[6] << 8)) * AK09918_UT_PER_LSB;
+			mag_ut[0] = AUX_MAG_AXIS_X(m);
+			mag_ut[1] = AUX_MAG_AXIS_Y(m);
+			mag_ut[2] = AUX_MAG_AXIS_Z(m);
+			fresh = 1;
+		}
+	}
+
+	if (i2cm_command(AK09918_ST1, I2CM_RW_READ, AK09918_BURST_LEN) == 0 && i2cm_go() == 0)
+		aux_mag_pending = 1;
+
+	return fresh ? 0 : 1;
+}
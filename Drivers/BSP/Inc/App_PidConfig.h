@@ -23,6 +23,21 @@ extern "C" {
 
     void App_Serial_Init(void);
 
+    // 5. float / Q31 / Q15 PID 周期数对比 (串口 "BENCH")，结果走 RTT
+    void PidBench_Run(void);
+
+    // 6. libm 与 fast_math.h 反三角函数周期数 / 误差对比 (同样由 "BENCH" 触发)
+    void MathBench_Run(void);
+
+    // 7. 陀螺零偏-温度表有新学习结果时写回 W25Q64 (主循环调用，内部限频)
+    void App_GyroBias_Poll(void);
+
+    // 8. 开机调度器用的分步版 App_Pid_Init (约定见 Boot.h)
+    int App_Pid_InitStep(void);
+
+    // 9. 串口命令的文本回复 (printf 格式，USART3 阻塞发送，一次最多 255 字节；只在主循环用)
+    void App_Serial_Printf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
 
 
 #ifdef __cplusplus
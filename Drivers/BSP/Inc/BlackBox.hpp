@@ -0,0 +1,257 @@
+#pragma once
+
+#include "main.h"
+#include "W25Q64.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "SEGGER_RTT.h"
+
+// ================== 配置参数 ==================
+#define BB_FLASH_BASE   0x000000U
+#define BB_FLASH_END    0x7FA000U   // 之上是学到的分段速度 (0x7FA000)、路线表 (0x7FB000)、参数表 (0x7FC000)、崩溃现场 (0x7FD000)、陀螺零偏表 (0x7FE000) 和旧 PID 扇区 (0x7FF000)
+#define BB_SECTOR       4096U
+#define BB_PAGE         256U
+#define BB_HALF_PAGES   4U          // 双缓冲每半 4 页 = 32 个样本 (50Hz 下 640ms)，大于扇区擦除最坏 400ms
+#define BB_MAGIC        0x31584242U // "BBX1"
+#define BB_DUMP_BAUD    921600U     // 导出时 USART3 临时切到的波特率
+#define BB_NORMAL_BAUD  115200U     // usart.c 里 USART3 的波特率
+
+/*
+ * 一个控制周期 (TIM7) 的快照，32 字节，一页 8 条
+ * 定点量：占空比 / PID 三项 x10000，轮速 mm/s，角速度 0.01°/s
+ */
+struct BlackBoxSample {
+    uint32_t t_ms;
+    uint16_t sensor;    // 去抖后的传感器字
+    uint8_t  question;  // 当前题号
+    uint8_t  state;     // 当前路段下标 (Route.hpp)
+    uint8_t  mode;      // 0 停车 / 1 航向保持 / 2 循线
+    uint8_t  flags;     // bit0 轮速闭环
+    int16_t  duty_l, duty_r;
+    int16_t  speed_l, speed_r;
+    int16_t  gyro_z;
+    float    yaw;       // °
+    int16_t  pid_p, pid_i, pid_d;  // 本周期起作用的外环 PID (按 mode 选循线或航向保持)
+    uint16_t seq;       // 样本序号低 16 位
+};
+static_assert(sizeof(BlackBoxSample) == 32, "BlackBoxSample must stay 32 bytes");
+static_assert(BB_PAGE % sizeof(BlackBoxSample) == 0, "page must hold whole samples");
+
+// 日志区第一页：会话信息；样本从第二页开始，遇到全 0xFF 的样本即结束
+struct BlackBoxHeader {
+    uint32_t magic;
+    uint16_t sample_size;
+    uint16_t reserved;
+    uint32_t start_ms;
+};
+
+/*
+ * BlackBox
+ * TIM7 中断里 record() 只把快照拷进 RAM 双缓冲的当前半区，半区写满就交给后台并切到另一半；
+ * 另一半还没落盘时丢弃样本并计数，中断里永远不等 Flash。
+ * 主循环 poll() 每次最多推进一步 (发一次扇区擦除或送一页数据)，芯片 BUSY 时直接返回，
+ * 擦除始终比写指针超前，保证最后一条样本后面是已擦除的 0xFF，掉电也能找到日志结尾。
+ */
+class BlackBox {
+public:
+    explicit BlackBox(W25Q64& flash) : _flash(flash) {}
+
+    // 开新会话 (覆盖上一次日志)；中断里也可以调用：只登记请求，真正的复位由下一次 poll() 做。
+    // 写指针 / 擦除进度 / 刷盘位置只归 poll() 改，中断里直接复位会和 poll() 正在做的加法交错
+    // (例如刚发出擦除、还没 _erased_until += 扇区就被复位，扇区 0 永远不擦，头写在旧数据上)
+    void start(uint32_t now_ms) {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        _active = false;            // 复位前的样本不再收
+        _restart_ms = now_ms;
+        _restart_pending = true;
+        __set_PRIMASK(primask);
+    }
+
+    // 停止记录：未满的半区补 0xFF 后交给后台，剩下的由 poll() 写完
+    void stop() {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        _restart_pending = false;
+        if (_active) {
+            _active = false;
+            if (_fill_idx > 0 && !_ready[_fill]) {
+                std::memset(&_buf[_fill][_fill_idx], 0xFF, (SAMPLES_PER_HALF - _fill_idx) * sizeof(BlackBoxSample));
+                _ready[_fill] = true;
+            }
+            _fill_idx = 0;
+        }
+        __set_PRIMASK(primask);
+        if (_dropped) RTT_Log("[BlackBox] stopped, %u samples dropped\r\n", (unsigned)_dropped);
+    }
+
+    bool recording() const { return _active || _restart_pending; }
+
+    // TIM7 中断调用
+    void record(BlackBoxSample& s) {
+        if (!_active) return;
+        if (_fill_idx == SAMPLES_PER_HALF) {
+            // 当前半区满了，另一半还在写 Flash：丢弃，不阻塞
+            if (_ready[_fill ^ 1]) {
+                _dropped++;
+                return;
+            }
+            _fill ^= 1;
+            _fill_idx = 0;
+        }
+        s.seq = _seq++;
+        _buf[_fill][_fill_idx++] = s;
+        if (_fill_idx == SAMPLES_PER_HALF) _ready[_fill] = true;
+    }
+
+    // 主循环调用：非阻塞，每次最多发一条 Flash 命令
+    void poll() {
+        if (_restart_pending) restart();
+        if (!_header_pending && !_ready[_flush_half]) return;
+        if (_flash.busy()) return;
+
+        // 擦除超前写指针：下一页也必须是 0xFF
+        if (_erased_until < BB_FLASH_END && _erased_until <= _write_addr + BB_PAGE) {
+            _flash.eraseSectorStart(_erased_until);
+            _erased_until += BB_SECTOR;
+            return;
+        }
+
+        if (_header_pending) {
+            _flash.writePageStart(BB_FLASH_BASE, (const uint8_t*)&_header, sizeof(_header));
+            _header_pending = false;
+            _write_addr = BB_FLASH_BASE + BB_PAGE;
+            return;
+        }
+
+        if (_write_addr + BB_PAGE > BB_FLASH_END) {
+            // 写满：停止并丢掉缓冲里剩下的
+            _active = false;
+            _ready[0] = _ready[1] = false;
+            RTT_Log("[BlackBox] flash full, recording stopped\r\n");
+            return;
+        }
+
+        const uint8_t* page = (const uint8_t*)&_buf[_flush_half][0] + _flush_page * BB_PAGE;
+        _flash.writePageStart(_write_addr, page, BB_PAGE);
+        _write_addr += BB_PAGE;
+        if (++_flush_page == BB_HALF_PAGES) {
+            _flush_page = 0;
+            _ready[_flush_half] = false;
+            _flush_half ^= 1;
+        }
+    }
+
+    /*
+     * 经 UART 导出 (阻塞)：先按原波特率发一行 "BBDUMP n=<样本数> size=32 baud=<导出波特率>"，
+     * 切到 BB_DUMP_BAUD 发原始样本 + 4 字节累加和，再切回原波特率发 "BBEND"。
+     */
+    uint32_t dump(UART_HandleTypeDef* huart) {
+        stop();
+        while (_header_pending || _ready[0] || _ready[1]) poll();
+        while (_flash.busy()) {}
+
+        BlackBoxHeader hdr{};
+        _flash.readData(BB_FLASH_BASE, (uint8_t*)&hdr, sizeof(hdr));
+        uint32_t n = (hdr.magic == BB_MAGIC && hdr.sample_size == sizeof(BlackBoxSample)) ? count() : 0;
+
+        char line[64];
+        int len = snprintf(line, sizeof(line), "BBDUMP n=%lu size=%u baud=%lu\r\n",
+                           (unsigned long)n, (unsigned)sizeof(BlackBoxSample), (unsigned long)BB_DUMP_BAUD);
+        HAL_UART_Transmit(huart, (uint8_t*)line, len, HAL_MAX_DELAY);
+        if (n == 0) return 0;
+
+        setBaud(huart, BB_DUMP_BAUD);
+        HAL_Delay(50); // 给上位机切波特率的时间
+
+        uint32_t sum = 0;
+        uint32_t addr = BB_FLASH_BASE + BB_PAGE;
+        for (uint32_t left = n; left > 0;) {
+            uint32_t k = left < SAMPLES_PER_PAGE ? left : SAMPLES_PER_PAGE;
+            uint16_t bytes = k * sizeof(BlackBoxSample);
+            _flash.readData(addr, _page, bytes);
+            for (uint16_t i = 0; i < bytes; i++) sum += _page[i];
+            HAL_UART_Transmit(huart, _page, bytes, HAL_MAX_DELAY);
+            addr += BB_PAGE;
+            left -= k;
+        }
+        HAL_UART_Transmit(huart, (uint8_t*)&sum, sizeof(sum), HAL_MAX_DELAY);
+
+        setBaud(huart, BB_NORMAL_BAUD);
+        len = snprintf(line, sizeof(line), "BBEND\r\n");
+        HAL_UART_Transmit(huart, (uint8_t*)line, len, HAL_MAX_DELAY);
+        return n;
+    }
+
+private:
+    static constexpr uint32_t SAMPLES_PER_PAGE = BB_PAGE / sizeof(BlackBoxSample);
+    static constexpr uint32_t SAMPLES_PER_HALF = SAMPLES_PER_PAGE * BB_HALF_PAGES;
+
+    // 执行 start() 的请求：主循环里关中断复位全部状态 (正在进行的擦除 / 写页不影响，扇区 0 会重新擦)
+    void restart() {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        if (_restart_pending) {
+            _restart_pending = false;
+            _fill = 0;
+            _fill_idx = 0;
+            _ready[0] = _ready[1] = false;
+            _flush_half = 0;
+            _flush_page = 0;
+            _seq = 0;
+            _dropped = 0;
+            _write_addr = BB_FLASH_BASE;
+            _erased_until = BB_FLASH_BASE;
+            _header = {BB_MAGIC, sizeof(BlackBoxSample), 0, _restart_ms};
+            _header_pending = true;
+            _active = true;
+        }
+        __set_PRIMASK(primask);
+    }
+
+    // 数到第一条全 0xFF 的样本为止
+    uint32_t count() {
+        uint32_t n = 0;
+        for (uint32_t addr = BB_FLASH_BASE + BB_PAGE; addr < BB_FLASH_END; addr += BB_PAGE) {
+            _flash.readData(addr, _page, BB_PAGE);
+            const BlackBoxSample* s = (const BlackBoxSample*)_page;
+            for (uint32_t i = 0; i < SAMPLES_PER_PAGE; i++, n++) {
+                if (s[i].t_ms == 0xFFFFFFFFU && s[i].seq == 0xFFFF) return n;
+            }
+        }
+        return n;
+    }
+
+    // 只改 BRR，不重新 HAL_UART_Init，接收 DMA 保持运行 (导出期间不会有命令进来)
+    static void setBaud(UART_HandleTypeDef* huart, uint32_t baud) {
+        static uint32_t brr_normal = 0;
+        while (!__HAL_UART_GET_FLAG(huart, UART_FLAG_TC)) {}
+        if (brr_normal == 0) brr_normal = huart->Instance->BRR;
+        __HAL_UART_DISABLE(huart);
+        huart->Instance->BRR = (uint32_t)((uint64_t)brr_normal * BB_NORMAL_BAUD / baud);
+        __HAL_UART_ENABLE(huart);
+    }
+
+    W25Q64& _flash;
+
+    BlackBoxSample _buf[2][SAMPLES_PER_HALF];
+    uint8_t _page[BB_PAGE];
+
+    volatile uint8_t _fill = 0;
+    volatile uint32_t _fill_idx = 0;
+    volatile bool _ready[2] = {false, false};
+    volatile bool _active = false;
+    uint8_t _flush_half = 0;
+    uint32_t _flush_page = 0;
+    uint16_t _seq = 0;
+    volatile uint32_t _dropped = 0;
+
+    BlackBoxHeader _header{};
+    volatile bool _header_pending = false;
+    volatile bool _restart_pending = false;
+    volatile uint32_t _restart_ms = 0;
+    uint32_t _write_addr = BB_FLASH_BASE;
+    uint32_t _erased_until = BB_FLASH_BASE;
+};
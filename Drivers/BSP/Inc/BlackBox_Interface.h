@@ -0,0 +1,24 @@
+#ifndef BLACK_BOX_INTERFACE_H
+#define BLACK_BOX_INTERFACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    void BlackBox_Start(uint32_t now_ms);  // 开新会话，覆盖上一次日志 (中断里可调，下一次 poll 时生效)
+    void BlackBox_Stop(void);
+    void BlackBox_Poll(void);              // 主循环调用，后台把样本写进 W25Q64
+    void BlackBox_Dump(void);              // 经 USART3 导出 (阻塞)
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+struct BlackBoxSample;
+void BlackBox_Record(BlackBoxSample& s); // TIM7 中断调用
+#endif
+
+#endif // BLACK_BOX_INTERFACE_H
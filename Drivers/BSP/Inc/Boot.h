@@ -0,0 +1,25 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 开机分步初始化约定：每个外设的初始化拆成可重入的 step 函数，每次调用只做一步
+ * 返回 BOOT_DONE 完成 / BOOT_FAIL 失败 (后续阶段照常进行) / >= 0 过这么多 ms 再调用
+ * 等待期间调度器去跑其它总线上的阶段，不再 HAL_Delay 空等
+ */
+#define BOOT_DONE  (-1)
+#define BOOT_FAIL  (-2)
+
+// main.c 调用：跑完所有初始化阶段后返回，并通过 RTT 打印各阶段 DWT 计时
+void Boot_Run(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BOOT_H
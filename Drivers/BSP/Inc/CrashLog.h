@@ -0,0 +1,87 @@
+#ifndef CRASH_LOG_H
+#define CRASH_LOG_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ================== 配置参数 ==================
+#define CRASH_MAGIC        0x48535243U  // "CRSH"
+#define CRASH_STACK_WORDS  64           // 异常帧往上保存的栈窗口 (字)
+#define CRASH_TRACE_LEN    16           // 最近事件环形队列长度 (2 的幂)
+
+typedef enum {
+    CRASH_HARDFAULT     = 3,  // 与异常号一致
+    CRASH_MEMMANAGE     = 4,
+    CRASH_BUSFAULT      = 5,
+    CRASH_USAGEFAULT    = 6,
+    CRASH_ERROR_HANDLER = 0x100,
+} CrashType;
+
+// 事件 id；arg 含义见各调用处
+typedef enum {
+    TRACE_BOOT = 1,    // arg: RCC_RSR 高 16 位 (复位原因)
+    TRACE_QUESTION,    // arg: 题号
+    TRACE_WAYPOINT,    // arg: 题号 << 8 | 进入的路段下标 (路线表里的段号)
+    TRACE_CMD,         // arg: 串口命令前两个字符
+    TRACE_FLASH_SAVE,  // arg: 0 PID / 1 陀螺零偏表 / 2 路线表 / 3 分段速度表 (ILC)
+    TRACE_BLACKBOX,    // arg: 0 停止 / 1 开始 / 2 导出
+} CrashTraceId;
+
+typedef struct {
+    uint32_t t_ms;
+    uint16_t id;
+    uint16_t arg;
+} CrashTraceEvent;
+
+/*
+ * 崩溃现场：异常入栈的 8 个寄存器 + 故障状态寄存器 + 栈窗口 + 最近事件
+ * Error_Handler 没有异常帧，pc/lr 填调用者地址
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t type;         // CrashType
+    uint32_t t_ms;
+    uint32_t exc_return;
+    uint32_t r0, r1, r2, r3, r12, lr, pc, xpsr;
+    uint32_t sp;           // 异常帧地址 (Error_Handler 时为当时的 MSP)
+    uint32_t cfsr, hfsr, mmfar, bfar;
+    uint32_t stack_words;  // stack[] 实际有效字数
+    uint32_t stack[CRASH_STACK_WORDS];
+    uint32_t trace_count;  // trace[] 有效条数，最旧的在前
+    CrashTraceEvent trace[CRASH_TRACE_LEN];
+    uint32_t sum;          // 前面所有字的累加和
+} CrashRecord;
+
+// 记一条事件 (中断里也可以调用)
+void CrashLog_Trace(uint16_t id, uint16_t arg);
+
+// 故障入口 (由 CrashLog_FaultEntry 跳过来)：保存现场后软复位，不返回
+__attribute__((noreturn)) void CrashLog_Fault(uint32_t* frame, uint32_t exc_return);
+
+// Error_Handler 入口：caller 为调用者返回地址，保存现场后软复位，不返回
+__attribute__((noreturn)) void CrashLog_Error(uint32_t caller);
+
+// 上次运行留在 no-init RAM 里的崩溃现场，没有或校验不过返回 NULL
+const CrashRecord* CrashLog_Pending(void);
+void CrashLog_ClearPending(void);
+
+// 校验一份现场 (Flash 读回的也用这个)
+int CrashLog_Valid(const CrashRecord* r);
+
+const char* CrashLog_TypeName(uint32_t type);
+
+/*
+ * HardFault / MemManage / BusFault / UsageFault 的向量直接指向这里 (CrashLog.cpp 里做别名，
+ * CubeMX 不再生成这四个处理函数)：纯汇编，按 EXC_RETURN 取异常帧所在的栈，r0 = 帧地址，r1 = EXC_RETURN，
+ * 跳到 CrashLog_Fault
+ */
+void CrashLog_FaultEntry(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRASH_LOG_H
@@ -0,0 +1,99 @@
+#pragma once
+#include "main.h"
+#include "W25Q64.hpp"
+#include "CrashLog.h"
+#include <cstdio>
+
+#include "SEGGER_RTT.h"
+
+// 崩溃现场放在陀螺零偏表 (0x7FE000) 下面一个扇区，只保留最近一次
+#define CRASH_FLASH_ADDR 0x7FD000
+
+static_assert(sizeof(CrashRecord) <= 4096, "crash record must fit in one sector");
+
+class CrashStorage {
+private:
+    W25Q64& _flash;
+    uint32_t _addr;
+
+    void send(UART_HandleTypeDef* huart, const char* line, int len) {
+        HAL_UART_Transmit(huart, (uint8_t*)line, len, HAL_MAX_DELAY);
+    }
+
+public:
+    CrashStorage(W25Q64& f, uint32_t addr = CRASH_FLASH_ADDR) : _flash(f), _addr(addr) {}
+
+    // 上电：上次运行崩溃留在 RAM 里的现场写进 Flash (Flash 已由 PidStorage::load 初始化)
+    bool persist() {
+        const CrashRecord* r = CrashLog_Pending();
+        if (r == nullptr) return false;
+
+        _flash.eraseSector(_addr);
+        const uint8_t* p = (const uint8_t*)r;
+        for (uint32_t off = 0; off < sizeof(CrashRecord); off += 256) {
+            uint32_t n = sizeof(CrashRecord) - off;
+            _flash.writePage(_addr + off, (uint8_t*)p + off, n > 256 ? 256 : n);
+        }
+        RTT_Log("[Crash] %s at pc=0x%08lx lr=0x%08lx saved to flash\r\n",
+                CrashLog_TypeName(r->type), (unsigned long)r->pc, (unsigned long)r->lr);
+        CrashLog_ClearPending();
+        return true;
+    }
+
+    bool load(CrashRecord& r) {
+        _flash.readData(_addr, (uint8_t*)&r, sizeof(r));
+        return CrashLog_Valid(&r) != 0;
+    }
+
+    void clear() {
+        _flash.eraseSector(_addr);
+    }
+
+    /*
+     * 以文本导出 (阻塞)，tools/crash/crash_symbolize.py 解析：
+     * CRASH type=.. t_ms=.. / REG ... / FAULT ... / STACK <地址> <8 个字> / TRACE t_ms id arg / CRASHEND
+     */
+    void dump(UART_HandleTypeDef* huart) {
+        static CrashRecord r;
+        char line[128];
+        int len;
+
+        if (!load(r)) {
+            len = snprintf(line, sizeof(line), "CRASH none\r\nCRASHEND\r\n");
+            send(huart, line, len);
+            return;
+        }
+
+        len = snprintf(line, sizeof(line), "CRASH type=%s t_ms=%lu exc_return=0x%08lx\r\n",
+                       CrashLog_TypeName(r.type), (unsigned long)r.t_ms, (unsigned long)r.exc_return);
+        send(huart, line, len);
+        len = snprintf(line, sizeof(line), "REG r0=0x%08lx r1=0x%08lx r2=0x%08lx r3=0x%08lx r12=0x%08lx\r\n",
+                       (unsigned long)r.r0, (unsigned long)r.r1, (unsigned long)r.r2,
+                       (unsigned long)r.r3, (unsigned long)r.r12);
+        send(huart, line, len);
+        len = snprintf(line, sizeof(line), "REG lr=0x%08lx pc=0x%08lx xpsr=0x%08lx sp=0x%08lx\r\n",
+                       (unsigned long)r.lr, (unsigned long)r.pc, (unsigned long)r.xpsr, (unsigned long)r.sp);
+        send(huart, line, len);
+        len = snprintf(line, sizeof(line), "FAULT cfsr=0x%08lx hfsr=0x%08lx mmfar=0x%08lx bfar=0x%08lx\r\n",
+                       (unsigned long)r.cfsr, (unsigned long)r.hfsr, (unsigned long)r.mmfar, (unsigned long)r.bfar);
+        send(huart, line, len);
+
+        for (uint32_t i = 0; i < r.stack_words; i += 8) {
+            len = snprintf(line, sizeof(line), "STACK 0x%08lx", (unsigned long)(r.sp + i * 4));
+            for (uint32_t k = i; k < i + 8 && k < r.stack_words; k++) {
+                len += snprintf(line + len, sizeof(line) - len, " %08lx", (unsigned long)r.stack[k]);
+            }
+            len += snprintf(line + len, sizeof(line) - len, "\r\n");
+            send(huart, line, len);
+        }
+
+        for (uint32_t i = 0; i < r.trace_count; i++) {
+            len = snprintf(line, sizeof(line), "TRACE %lu %u %u\r\n", (unsigned long)r.trace[i].t_ms,
+                           (unsigned)r.trace[i].id, (unsigned)r.trace[i].arg);
+            send(huart, line, len);
+        }
+
+        len = snprintf(line, sizeof(line), "CRASHEND\r\n");
+        send(huart, line, len);
+    }
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "main.h"
+#include "Odometry.hpp"
+#include <cmath>
+#include <cstdint>
+
+// ================== 配置参数 ==================
+#define EV_STALL_MS   100U   // 超过这么久没有 A 相边沿视为停转
+
+// 编码器 A 相引脚的 EXTI 配置：引脚保持 TIM 复用功能，EXTI 只旁路监听同一输入
+struct EncoderPhaseA {
+    uint16_t  pin;
+    uint32_t  line;      // EXTI_LINE_x
+    uint32_t  port;      // EXTI_GPIOx
+    IRQn_Type irq;
+    uint32_t  prio;
+};
+
+// 左轮 TIM2_CH1 = PA0 (EXTI0 独占，和内环同为最高优先级，时间戳最准)
+constexpr EncoderPhaseA ENC_LEFT_A  = {GPIO_PIN_0, EXTI_LINE_0, EXTI_GPIOA, EXTI0_IRQn, 0};
+// 右轮 TIM3_CH1 = PC6 (EXTI9_5 与传感器 PA8 共用，只能跟 TIM7 同为 1)
+constexpr EncoderPhaseA ENC_RIGHT_A = {GPIO_PIN_6, EXTI_LINE_6, EXTI_GPIOC, EXTI9_5_IRQn, 1};
+
+/*
+ * EncoderVelocity
+ * M/T 法测速：A 相每个边沿进 EXTI，记录 (DWT 时间, 编码器计数) 一对；
+ * 控制周期取最近一对边沿，用 "两次采样之间的计数差 / 对应两个边沿的时间差" 求速度。
+ * 分子分母都对齐到真实边沿，高速时等价于 M 法 (多计数平均)，
+ * 低速一个周期只有 0~1 个边沿时自动退化为 T 法 (单边沿周期)，不再有计数量化误差。
+ * 本周期没有新边沿时，真实速度不会超过 1 个计数 / 距上个边沿的时间，用它逐步压低估计值；
+ * 超过 EV_STALL_MS 判停转。
+ * 计数方向和上一段相反时，这段间隔里轮子折返过 (同一个 A 相边沿来回各计一次，净位移约为 0)，
+ * 计数差 / 时间差没有意义，速度记 0，这个边沿只作下一段的起点；静止时在边沿上抖动也因此不会测出速度。
+ */
+class EncoderVelocity {
+public:
+    EncoderVelocity(TIM_HandleTypeDef* enc, int8_t dir, const EncoderPhaseA& a)
+        : _enc(enc), _dir(dir), _a(a) {}
+
+    // 编码器启动之后调用
+    void begin() {
+        __HAL_RCC_SYSCFG_CLK_ENABLE();
+
+        EXTI_HandleTypeDef hexti{};
+        EXTI_ConfigTypeDef cfg{};
+        cfg.Line = _a.line;
+        cfg.Mode = EXTI_MODE_INTERRUPT;
+        cfg.Trigger = EXTI_TRIGGER_RISING_FALLING;
+        cfg.GPIOSel = _a.port;
+        cfg.PendClearSource = EXTI_D3_PENDCLR_SRC_NONE;
+        HAL_EXTI_SetConfigLine(&hexti, &cfg);
+
+        reset();
+
+        HAL_NVIC_SetPriority(_a.irq, _a.prio, 0);
+        HAL_NVIC_EnableIRQ(_a.irq);
+    }
+
+    void reset() {
+        _edge_cnt = __HAL_TIM_GET_COUNTER(_enc);
+        _edge_cyc = DWT->CYCCNT;
+        _prev_cnt = _edge_cnt;
+        _prev_cyc = _edge_cyc;
+        _valid = false;
+        _last_sign = 0;
+        _speed = 0.0f;
+    }
+
+    uint16_t pin() const { return _a.pin; }
+
+    // EXTI 回调：A 相边沿 (TI1 模式下每个边沿正好计 1 个数)
+    void onEdge(uint32_t cyc) {
+        uint32_t cnt = __HAL_TIM_GET_COUNTER(_enc);
+        _seq = _seq + 1U;
+        __DMB();
+        _edge_cyc = cyc;
+        _edge_cnt = cnt;
+        __DMB();
+        _seq = _seq + 1U;
+    }
+
+    // 控制周期调用，返回轮速 m/s
+    float sample(uint32_t now) {
+        const float clk = (float)SystemCoreClock;
+
+        // 读者优先级可能高于写者 (右轮)，不能自旋等写完：写到一半就当本周期没有新边沿
+        uint32_t cyc = _prev_cyc;
+        uint32_t cnt = _prev_cnt;
+        uint32_t seq = _seq;
+        if ((seq & 1U) == 0U) {
+            __DMB();
+            uint32_t c = _edge_cyc;
+            uint32_t n = _edge_cnt;
+            __DMB();
+            if (seq == _seq) {
+                cyc = c;
+                cnt = n;
+            }
+        }
+
+        int32_t dn = _dir * encoderCountDiff(_enc, cnt, _prev_cnt);
+        if (dn != 0) {
+            uint32_t dt = cyc - _prev_cyc;
+            int8_t sign = (dn > 0) ? 1 : -1;
+            if (_valid && sign != _last_sign) {
+                _speed = 0.0f;   // 换向
+            } else if (_valid && dt > 0U) {
+                _speed = (float)dn * ODOM_M_PER_COUNT * clk / (float)dt;
+            }
+            _prev_cyc = cyc;
+            _prev_cnt = cnt;
+            _last_sign = sign;
+            _valid = true;
+            return _speed;
+        }
+
+        uint32_t since = now - _prev_cyc;
+        if (since > (SystemCoreClock / 1000U) * EV_STALL_MS) {
+            _valid = false;   // 停太久，下个边沿只作起点，不拿超长间隔算速度
+            _speed = 0.0f;
+        } else if (since > 0U) {
+            float bound = ODOM_M_PER_COUNT * clk / (float)since;
+            if (fabsf(_speed) > bound) _speed = copysignf(bound, _speed);
+        }
+        return _speed;
+    }
+
+    float speed() const { return _speed; }
+
+private:
+    TIM_HandleTypeDef* _enc;
+    int8_t _dir;
+    EncoderPhaseA _a;
+
+    // EXTI 写
+    volatile uint32_t _seq = 0;
+    volatile uint32_t _edge_cyc = 0;
+    volatile uint32_t _edge_cnt = 0;
+
+    // 控制周期私有
+    uint32_t _prev_cyc = 0;
+    uint32_t _prev_cnt = 0;
+    bool  _valid = false;
+    int8_t _last_sign = 0;   // 上一段的计数方向
+    float _speed = 0.0f;
+};
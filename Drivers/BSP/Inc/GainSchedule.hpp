@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+ * PID 增益调度
+ * 每种行驶方式 (循线 / 航向保持) 一张小表：GS_POINTS 个速度断点，每个断点一组 (kp, ki, kd)。
+ * 控制周期按当前基础速度在相邻断点间线性插值，断点外取端点值；每周期十几次浮点运算。
+ * 第 0 个断点的增益就是 lpid.* / fpid.* (原来在低速下整定的那组)，断点速度见 gs.v0..gs.v2。
+ * 高速断点的某个增益为负 (GS_INHERIT) 时跟随第 0 个断点，没单独调过的断点和打开调度前一样。
+ */
+#define GS_POINTS  3
+#define GS_INHERIT (-1.0f)
+
+struct PidGains {
+    float kp, ki, kd;
+};
+
+// 负值的分量换成 base 对应的分量
+inline PidGains GainSchedule_inherit(const PidGains& g, const PidGains& base) {
+    return {g.kp < 0.0f ? base.kp : g.kp,
+            g.ki < 0.0f ? base.ki : g.ki,
+            g.kd < 0.0f ? base.kd : g.kd};
+}
+
+// bp: 断点速度 (应递增，不递增的区间直接跳过，不会除零)；g: 各断点增益
+inline PidGains GainSchedule_lookup(const float* bp, const PidGains* g, uint8_t n, float v) {
+    if (n == 0) return {0.0f, 0.0f, 0.0f};
+    if (v <= bp[0]) return g[0];
+    for (uint8_t i = 1; i < n; i++) {
+        if (v < bp[i]) {
+            float t = (v - bp[i - 1]) / (bp[i] - bp[i - 1]);
+            return {g[i - 1].kp + t * (g[i].kp - g[i - 1].kp),
+                    g[i - 1].ki + t * (g[i].ki - g[i - 1].ki),
+                    g[i - 1].kd + t * (g[i].kd - g[i - 1].kd)};
+        }
+    }
+    return g[n - 1];
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "W25Q64.hpp"
+#include "gyro_bias.h"
+#include "CrashLog.h"
+
+#include "SEGGER_RTT.h"
+
+// 陀螺零偏-温度表放在 PID 参数扇区 (0x7FF000) 下面一个扇区，整表 < 1 页
+#define GYRO_BIAS_FLASH_ADDR       0x7FE000
+#define GYRO_BIAS_SAVE_INTERVAL_MS 60000U   // 学习后最多每分钟落盘一次 (擦写一次阻塞约 50ms)
+
+static_assert(sizeof(GyroBiasTable) <= 256, "gyro bias table must fit in one page");
+
+class GyroBiasStorage {
+private:
+    W25Q64& _flash;
+    uint32_t _addr;
+    uint32_t _last_save_ms = 0;
+
+public:
+    GyroBiasStorage(W25Q64& f, uint32_t addr = GYRO_BIAS_FLASH_ADDR) : _flash(f), _addr(addr) {}
+
+    // 上电：读 Flash 导入模型 (Flash 已由 PidStorage::load 初始化)
+    bool load() {
+        GyroBiasTable t{};
+        _flash.readData(_addr, (uint8_t*)&t, sizeof(t));
+        return GyroBias_import(&t) != 0;
+    }
+
+    void save() {
+        GyroBiasTable t{};
+        GyroBias_export(&t);
+        _flash.eraseSector(_addr);
+        _flash.writePage(_addr, (uint8_t*)&t, sizeof(t));
+    }
+
+    // 主循环调用：有新学到的零偏且距上次保存足够久才写
+    void poll(uint32_t now_ms) {
+        if (!GyroBias_dirty()) return;
+        if (now_ms - _last_save_ms < GYRO_BIAS_SAVE_INTERVAL_MS) return;
+        _last_save_ms = now_ms;
+        save();
+        CrashLog_Trace(TRACE_FLASH_SAVE, 1);
+        RTT_Log("[GyroBias] saved, %d bins learned\r\n", GyroBias_learnedBins());
+    }
+};
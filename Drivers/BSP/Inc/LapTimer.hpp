@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Route.hpp"
+#include <cstdint>
+#include <cstring>
+
+/*
+ * 一段的成绩 (最近一圈)
+ * peak_err 的单位随行驶方式：循线段是传感器位置误差 (权重单位)，航向保持段是航向误差 (°)
+ */
+struct SegmentSplit {
+    uint32_t ms;          // 本段用时
+    float    peak_err;    // 本段 |误差| 峰值
+    uint32_t sat_ms;      // 本段外环 PID 输出顶到限幅的累计时间
+    uint8_t  drive;       // route::Drive
+    uint8_t  lost;        // 本段丢线停车 (这一圈作废)
+};
+
+struct LapSummary {
+    uint32_t laps;
+    uint32_t last_ms;
+    uint32_t best_ms;
+    uint32_t total_ms;    // 平均 = total_ms / laps
+};
+
+/*
+ * LapTimer
+ * 挂在路线切换上：确认题号开始一圈，每进一段记上一段的用时，进入最后一段 (END) 记一圈。
+ * 路段切换和控制周期都在 TIM7 / EXTI (同优先级) 里调用，互相不会打断；
+ * 主循环读取时关中断拷贝。
+ */
+class LapTimer {
+public:
+    // 确认题号：开始新的一圈 (路线为空时不计时)
+    void begin(uint8_t q, bool has_route, uint32_t now_ms) {
+        _q = q;
+        _running = has_route && q >= 1 && q <= ROUTE_QUESTIONS;
+        _lap_t0 = now_ms;
+        _cur_count = 0;
+        _seg_open = false;
+    }
+
+    // 进入第 idx 段；terminal 表示这段是 END (或路线走完)，一圈到此结束
+    void segment(uint8_t idx, uint8_t drive, bool terminal, uint32_t now_ms) {
+        if (!_running) return;
+        if (_seg_open) _cur[_cur_idx].ms = now_ms - _seg_t0;
+        _seg_open = false;
+
+        if (terminal) {
+            finishLap(now_ms);
+            return;
+        }
+        if (idx >= ROUTE_MAX_SEG) return;
+        _cur_idx = idx;
+        _cur[idx] = {0, 0.0f, 0, drive, 0};
+        if (idx + 1 > _cur_count) _cur_count = idx + 1;
+        _seg_t0 = now_ms;
+        _seg_open = true;
+    }
+
+    // 每个控制周期：本周期误差和外环是否饱和
+    void sample(float err, bool saturated, uint32_t dt_ms) {
+        if (!_seg_open) return;
+        SegmentSplit& s = _cur[_cur_idx];
+        if (err < 0.0f) err = -err;
+        if (err > s.peak_err) s.peak_err = err;
+        if (saturated) s.sat_ms += dt_ms;
+    }
+
+    // 循线段丢线停车：本段记为丢线，这一圈作废 (不计圈速，分段成绩照样给学习用)
+    void lost(uint32_t now_ms) {
+        if (!_seg_open) return;
+        _cur[_cur_idx].ms = now_ms - _seg_t0;
+        _cur[_cur_idx].lost = 1;
+        _seg_open = false;
+        _running = false;
+        publish(true);
+    }
+
+    bool running() const { return _running; }
+    uint8_t question() const { return _q; }
+    uint32_t elapsed(uint32_t now_ms) const { return _running ? now_ms - _lap_t0 : 0; }
+
+    const LapSummary& summary(uint8_t q) const { return _sum[(q >= 1 && q <= ROUTE_QUESTIONS) ? q - 1 : 0]; }
+
+    // 最近一圈的分段成绩；aborted: 这一圈因丢线作废
+    uint8_t lastSplits(SegmentSplit* out, uint8_t max, uint8_t& q, bool& aborted) const {
+        uint8_t n = _last_count < max ? _last_count : max;
+        std::memcpy(out, _last, n * sizeof(SegmentSplit));
+        q = _last_q;
+        aborted = _last_aborted;
+        return n;
+    }
+
+    // 每结束 (或作废) 一圈加 1，主循环据此发现新成绩
+    uint32_t lapSeq() const { return _seq; }
+
+    void reset() {
+        std::memset(_sum, 0, sizeof(_sum));
+        _last_count = 0;
+        _running = false;
+        _seg_open = false;
+    }
+
+private:
+    void finishLap(uint32_t now_ms) {
+        _running = false;
+        if (_cur_count == 0) return;
+
+        uint32_t lap = now_ms - _lap_t0;
+        LapSummary& s = _sum[_q - 1];
+        s.laps++;
+        s.last_ms = lap;
+        if (s.best_ms == 0 || lap < s.best_ms) s.best_ms = lap;
+        s.total_ms += lap;
+
+        publish(false);
+    }
+
+    void publish(bool aborted) {
+        std::memcpy(_last, _cur, _cur_count * sizeof(SegmentSplit));
+        _last_count = _cur_count;
+        _last_q = _q;
+        _last_aborted = aborted;
+        _seq++;
+    }
+
+    LapSummary _sum[ROUTE_QUESTIONS] = {};
+
+    SegmentSplit _cur[ROUTE_MAX_SEG] = {};
+    uint8_t  _cur_count = 0;
+    uint8_t  _cur_idx = 0;
+    bool     _seg_open = false;
+    uint32_t _seg_t0 = 0;
+
+    SegmentSplit _last[ROUTE_MAX_SEG] = {};
+    uint8_t  _last_count = 0;
+    uint8_t  _last_q = 0;
+    bool     _last_aborted = false;
+    uint32_t _seq = 0;
+
+    uint8_t  _q = 0;
+    bool     _running = false;
+    uint32_t _lap_t0 = 0;
+};
@@ -0,0 +1,31 @@
+#ifndef LAP_TIMER_INTERFACE_H
+#define LAP_TIMER_INTERFACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    void LapTimer_Report(void);    // 串口 "LAP"：各题圈速 + 最近一圈分段成绩，发到 USART3
+    void LapTimer_Reset(void);     // 串口 "LAPRST"
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+struct LapSummary;
+struct SegmentSplit;
+// 以下在 TIM7 / EXTI 里由 LineFollower 调用
+void LapTimer_Begin(uint8_t q, bool has_route, uint32_t now_ms);
+void LapTimer_Segment(uint8_t idx, uint8_t drive, bool terminal, uint32_t now_ms);
+void LapTimer_Sample(float err, bool saturated, uint32_t dt_ms);
+void LapTimer_Lost(uint32_t now_ms);
+// 主循环读取 (关中断拷贝)
+void LapTimer_Summary(uint8_t q, LapSummary& out, uint32_t& elapsed_ms);
+// 最近一圈的分段成绩，返回圈序号 (每结束 / 作废一圈加 1)
+uint32_t LapTimer_LastLap(SegmentSplit* out, uint8_t max, uint8_t& n, uint8_t& q, bool& aborted);
+#endif
+
+#endif // LAP_TIMER_INTERFACE_H
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "main.h"
+
+// 一次传感器口边沿：EXTI 进中断时的 DWT 时间 + 当时的传感器字
+struct LineEdge {
+    uint32_t cyc;
+    uint16_t raw;
+};
+
+/*
+ * LineEdgeLog
+ * 单生产者 (EXTI) / 单消费者 (控制逻辑) 无锁环形队列。
+ * head 只由 push 写，tail 只由 pop 写，靠 DMB 保证数据先于索引可见。
+ * 满了丢弃新事件并计数，不会覆盖尚未消费的边沿。
+ */
+template <size_t N>
+class LineEdgeLog {
+    static_assert((N & (N - 1)) == 0, "N must be a power of two");
+
+public:
+    bool push(const LineEdge& e) {
+        uint32_t head = _head;
+        if (head - _tail >= N) {
+            _dropped++;
+            return false;
+        }
+        _buf[head & (N - 1)] = e;
+        __DMB();
+        _head = head + 1;
+        return true;
+    }
+
+    bool pop(LineEdge& e) {
+        uint32_t tail = _tail;
+        if (tail == _head) return false;
+        __DMB();
+        e = _buf[tail & (N - 1)];
+        __DMB();
+        _tail = tail + 1;
+        return true;
+    }
+
+    uint32_t dropped() const { return _dropped; }
+
+private:
+    LineEdge _buf[N]{};
+    volatile uint32_t _head = 0;
+    volatile uint32_t _tail = 0;
+    volatile uint32_t _dropped = 0;
+};
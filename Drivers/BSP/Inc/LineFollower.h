@@ -7,75 +7,132 @@
 
 #include "PidStorage.hpp"
 #include "Prompt.hpp"
+#include "SensorArray.hpp"
+#include "LineSampler.hpp"
+#include "LineEdgeLog.hpp"
+#include "Odometry.hpp"
+#include "WheelSpeedLoop.hpp"
+#include "MotorOutput.hpp"
+#include "BlackBox.hpp"
+#include "CrashLog.h"
+#include "Params.hpp"
+#include "Route.hpp"
+#include "LapTimer_Interface.h"
+#include "SpeedProfile.hpp"
+#include "GainSchedule.hpp"
+#include "MotionProfile.hpp"
 
 // ================== 配置参数 ==================
-#define LF_SENSOR_MASK   0x9D00  // PA15,PA12,PA11,PA10,PA8
+#define LF_SENSOR_MASK   (LineSensors::mask)  // 线束配置见 SensorArray.hpp
 #define LF_PWM_PERIOD    11999
+#define LF_EDGE_LOG_LEN     32   // EXTI 边沿队列长度 (2 的幂)
+#define LF_EDGE_HOLDOFF_MS  30   // 进入路段 (含边沿采纳的航点) 后的屏蔽时间
+#define LF_EDGE_MIN_MS      5    // 有线/无线翻转至少保持这么久才算边沿，更短的当毛刺
+#define LF_CTRL_DT          0.02f // TIM7 控制周期 (s)
+#define LF_CTRL_MS          20U
+#define LF_YAW_RATE_SIGN    (-1.0f) // IMU 输出的 yaw 取了负号：d(yaw)/dt = -gz
+#define LF_TURN_D_ALPHA     0.6f // 循线 PID 微分项低通系数 (1 = 不滤波)
+#define LF_PID_SAT          0.999f // 外环 PID 输出 |u| 超过它算顶到限幅 (限幅 ±1)，圈速统计用
+#define LF_SPEED_LOOP_EN    1    // 1: 外环输出经 1kHz 轮速内环闭环；0: 直接写占空比 (开环)
 
 extern float User_YPR[3];
+extern float User_Rates[3];
 
 class LineFollower {
 private:
-    TIM_HandleTypeDef* _htim;
-    uint32_t _ch_L1, _ch_L2;
-    uint32_t _ch_R1, _ch_R2;
-    uint32_t _pwm_arr;
+    // TIM1 四路比较值 DMA burst 原子更新
+    MotorOutput _motor;
 
-    PidController<float> _pidTurn;
-    PidController<float> _pidForward;
+    // 循线：误差来自查表，阶跃明显，微分项低通。设定值恒为 0，微分作用在误差上和作用在测量值上一样，
+    // 不需要 DerivOnMeasurement
+    PidController<float, pid::DFilter, pid::RecordTerms> _pidTurn;
+    // 航向保持：微分直接用陀螺仪 Z 轴角速度 (不用对 50Hz 的 yaw 差分)；FPID 给了 I 时用条件积分防饱和
+    PidController<float, pid::ExternalDerivative, pid::AntiWindupClamp, pid::RecordTerms> _pidForward;
 
     float _base_speed;
 
+    // 传感器口 DMA 过采样 + 多数表决去抖
+    LineSampler _sampler;
+
+    // 编码器里程计 (TIM2 左 / TIM3 右)
+    Odometry _odom;
+
+    // 1kHz 轮速内环 (TIM17)
+    WheelSpeedLoop _wheels;
+    bool _closed_loop = LF_SPEED_LOOP_EN;
+
     bool  _yaw_ref_inited = false;
     float _yaw_ref_deg    = 0.0f;
 
+    // 本周期的运动方式 (黑匣子记录用)：0 停车 / 1 航向保持 / 2 循线
+    uint8_t _drive_mode = 0;
+
+    // S 曲线速度设定 (MotionProfile.hpp) 和换段时的差速过渡
+    SCurve _profile;
+    float  _diff_out   = 0.0f;    // 上一周期实际输出的差速
+    bool   _diff_blend = false;   // 换了行驶方式：差速按 mp.turn_slew 限斜率追上外环输出
+
+    static int16_t toQ4(float v) { // x10000 定点，黑匣子用
+        v *= 10000.0f;
+        return (int16_t)(v > 32767.0f ? 32767.0f : (v < -32768.0f ? -32768.0f : v));
+    }
+
     static float wrapAngleDeg(float err_deg) {
         while (err_deg > 180.0f) err_deg -= 360.0f;
         while (err_deg < -180.0f) err_deg += 360.0f;
         return err_deg;
     }
 
-    void setSingleMotor(uint32_t ch1, uint32_t ch2, float speed) {
-        if (speed > 1.0f) speed = 1.0f;
-        if (speed < -1.0f) speed = -1.0f;
+    // ====== 公共运动合成 ======
+    // 速度以满占空比为 1 归一化；闭环时换算成轮速目标交给内环，前馈保证增益为 0 时与开环一致
+    void setEndSpeed(float turn_adjust, float yaw_adjust) {
+        float diff = turn_adjust - yaw_adjust;
+        if (_diff_blend) {
+            float d = std::clamp(diff, _diff_out - prm::mp_turn_slew, _diff_out + prm::mp_turn_slew);
+            if (d == diff) _diff_blend = false;
+            diff = d;
+        }
+        _diff_out = diff;
+        float speed_l = std::clamp(_base_speed - diff, -1.0f, 1.0f);
+        float speed_r = std::clamp(_base_speed + diff, -1.0f, 1.0f);
 
-        uint32_t duty_inv;
-        if (speed >= 0.0f) {
-            duty_inv = (uint32_t)((1.0f - speed) * _pwm_arr);
-            __HAL_TIM_SET_COMPARE(_htim, ch1, _pwm_arr);
-            __HAL_TIM_SET_COMPARE(_htim, ch2, duty_inv);
-        } else {
-            float abs_s = -speed;
-            duty_inv = (uint32_t)((1.0f - abs_s) * _pwm_arr);
-            __HAL_TIM_SET_COMPARE(_htim, ch1, duty_inv);
-            __HAL_TIM_SET_COMPARE(_htim, ch2, _pwm_arr);
+        if (_closed_loop) {
+            _wheels.setTarget(speed_l * WSL_VMAX_MPS, speed_r * WSL_VMAX_MPS);
+            return;
         }
+        _motor.set(speed_l, speed_r);
     }
 
-    // ====== 公共运动合成 ======
-    void setEndSpeed(float turn_adjust, float yaw_adjust) {
-        float diff = turn_adjust - yaw_adjust;
-        float speed_l = _base_speed - diff;
-        float speed_r = _base_speed + diff;
+    // 断电：内环同时退出闭环并清积分，否则下一毫秒又会被内环写回去。
+    // 速度规划不动：循线丢线一两个周期又找回来时，设定值接着原来的速度，不从 0 重新爬
+    void cutMotors() {
+        _drive_mode = 0;
+        _diff_out = 0.0f;
+        _wheels.stop();
+        _motor.stop();
+    }
 
-        setSingleMotor(_ch_L1, _ch_L2, speed_l);
-        setSingleMotor(_ch_R2, _ch_R1, speed_r);
+    // 停车 (停车段 / 路线走完 / 换题 / 切换开闭环)：断电并把速度规划清零
+    void stopMotors() {
+        cutMotors();
+        _profile.reset();
     }
 
     // ====== 传感器位置误差（带 count==0 保护）======
+    // 权重平均在编译期展开成查找表，端口值移位后直接作下标，这里只剩一次查表
     bool calcPositionError(uint16_t raw, float& position_error_out) {
-        float sum = 0.0f;
-        int count = 0;
-
-        if (raw & GPIO_PIN_15) { sum += -5.0f; count++; }
-        if (raw & GPIO_PIN_12) { sum +=  2.0f; count++; }
-        if (raw & GPIO_PIN_11) { sum +=  0.0f; count++; }
-        if (raw & GPIO_PIN_10) { sum +=  2.0f; count++; }
-        if (raw & GPIO_PIN_8)  { sum +=  5.0f; count++; }
+        return LineSensors::positionError(raw, position_error_out);
+    }
 
-        if (count == 0) return false;
-        position_error_out = sum / (float)count;
-        return true;
+    // ====== 增益调度：按本周期基础速度插值 (断点 0 是 lpid.* / fpid.*，其余见 Params.hpp) ======
+    // 积分存的是误差累加和，ki 随速度平滑变化时 I 项也跟着平滑变化
+    template <typename Pid>
+    void scheduleGains(Pid& pid, const PidGains& base, const PidGains* hi) {
+        PidGains g[GS_POINTS];
+        g[0] = base;
+        for (uint8_t k = 1; k < GS_POINTS; k++) g[k] = GainSchedule_inherit(hi[k - 1], base);
+        PidGains s = GainSchedule_lookup(prm::gs_v, g, GS_POINTS, _base_speed);
+        pid.setTunings(s.kp, s.ki, s.kd);
     }
 
     // ====== 直线段：航向保持（raw==0）======
@@ -87,7 +144,12 @@ private:
         }
 
         float yaw_err = wrapAngleDeg(yaw_now - _yaw_ref_deg);
-        float yaw_adjust = _pidForward.compute(0.0f, yaw_err);
+        // 角速度换算成每周期变化量，与原来的差分微分同量纲，FPID 的 D 参数不用重调
+        float yaw_step = LF_YAW_RATE_SIGN * User_Rates[2] * LF_CTRL_DT;
+        if (prm::gs_enable) scheduleGains(_pidForward, {prm::fpid_p, prm::fpid_i, prm::fpid_d}, prm::fpid_gs);
+        float yaw_adjust = _pidForward.compute(0.0f, yaw_err, yaw_step);
+        _drive_mode = 1;
+        LapTimer_Sample(yaw_err, std::fabs(yaw_adjust) >= LF_PID_SAT, LF_CTRL_MS);
 
         setEndSpeed(0.0f, yaw_adjust);
     }
@@ -96,54 +158,236 @@ private:
     void driveArcLineFollow(uint16_t raw) {
         float position_error = 0.0f;
         if (!calcPositionError(raw, position_error)) {
-            // 保险：算不出误差就停
-            setSingleMotor(_ch_L1, _ch_L2, 0.0f);
-            setSingleMotor(_ch_R1, _ch_R2, 0.0f);
+            // 保险：算不出误差就停 (这一圈记为丢线，速度学习据此退回本段速度)
+            if (_drive_mode != 0) LapTimer_Lost(HAL_GetTick());
+            cutMotors();
             return;
         }
 
+        if (prm::gs_enable) scheduleGains(_pidTurn, {prm::lpid_p, prm::lpid_i, prm::lpid_d}, prm::lpid_gs);
         float turn_adjust = _pidTurn.compute(0.0f, position_error);
+        _drive_mode = 2;
+        LapTimer_Sample(position_error, std::fabs(turn_adjust) >= LF_PID_SAT, LF_CTRL_MS);
         setEndSpeed(turn_adjust, 0.0f);
     }
 
-    // ================== Q1 状态机 ==================
-    enum class Q1State : uint8_t { Idle=0, GoStraight_AB, StopAtB };
-    Q1State _q1_state = Q1State::Idle;
-    bool _q1_prev_hasLine = false;
-    bool _q1_prompted = false;
+    // ================== 路线解释器 (路线表见 Route.hpp / Routes.cpp) ==================
+    Route    _route{nullptr, 0};
+    uint8_t  _seg_idx   = 0;      // == _route.count: 路线走完
+    float    _seg_dist0 = 0.0f;   // 进入本段时的里程 / 航向 / 时间
+    float    _seg_yaw0  = 0.0f;
+    uint32_t _seg_t0    = 0;
+    uint32_t _seg_cyc0  = 0;      // 进入本段的 DWT 时刻 (边沿触发时取边沿时间)，边沿屏蔽从这里算
+    bool     _seg_settled = false; // 已过屏蔽窗口 (之后不再比较 _seg_cyc0，DWT 回绕也不会误判)
+    uint8_t  _laps_left = 1;      // 含当前圈
+    float    _seg_len[ROUTE_MAX_SEG] = {};  // 上一圈各段实际走过的距离 (m)，0 = 还不知道
+    float    _plan_cruise  = 0.0f;  // 本段巡航速度 / 出口速度 (占空比) / 提前刹车距离 (m)，进段时算好
+    float    _plan_exit    = 0.0f;
+    float    _plan_brake_m = 0.0f;
+
+    const RouteSegment* currentSegment() const {
+        return _seg_idx < _route.count ? &_route.seg[_seg_idx] : nullptr;
+    }
+
+    // 学过的段用学到的速度 (SpeedProfile.hpp)，否则用参数表的默认速度
+    float cruiseSpeed(uint8_t i) const {
+        const RouteSegment& s = _route.seg[i];
+        if (s.drive == route::Drive::Stop) return 0.0f;
+        float def = s.drive == route::Drive::YawHold ? prm::speed_straight : prm::speed_arc;
+        return SpeedProfile_speed(_active_q, i, def);
+    }
+
+    // 进段时规划本段：出口速度取下一段的巡航速度，按 S 曲线算出需要提前多远开始减速
+    void planSegment() {
+        _plan_cruise = cruiseSpeed(_seg_idx);
+        uint8_t next = _seg_idx + 1;
+        // 多圈时终点段不会执行，出口接下一圈的第一段
+        if (next < _route.count && _route.seg[next].exit == route::Trigger::End && _laps_left > 1 && _route.count > 1) next = 0;
+        float exit = next < _route.count ? cruiseSpeed(next) : 0.0f;
+        // 进航点前只减到蠕行速度：边沿 / 距离条件要靠车开过去才能触发，停车段自己再刹到 0
+        if (exit < prm::mp_creep) exit = prm::mp_creep;
+        if (exit > _plan_cruise) exit = _plan_cruise;
+        _plan_exit = exit;
+        _plan_brake_m = SCurve_brakeDistance(_plan_cruise * WSL_VMAX_MPS, exit * WSL_VMAX_MPS,
+                                             {prm::mp_acc, prm::mp_jerk});
+    }
 
-    void q1_enter(Q1State s) {
-        _q1_state = s;
-        _q1_prompted = false;
+    // 速度单位是占空比：附着力上限 (m/s²、m/s³) 按满占空比车速换算
+    static MotionLimits limits() {
+        return {prm::mp_acc / WSL_VMAX_MPS, prm::mp_jerk / WSL_VMAX_MPS};
     }
 
-    // ================== Q2 状态机：A->B->C->D->A ==================
-    enum class Q2State : uint8_t { Idle=0, Straight_AB, Arc_BC, Straight_CD, Arc_DA, Done };
-    Q2State _q2_state = Q2State::Idle;
-    bool _q2_prev_hasLine = false;
-    bool _q2_prompted = false;
+    // 本周期速度设定：本段长度已知 (距离条件 / 上一圈量到的) 且剩余距离只够刹车时，目标切到出口速度
+    float profiledSpeed(const RouteSegment& seg) {
+        if (!prm::mp_enable) {
+            _profile.set(_plan_cruise);
+            return _plan_cruise;
+        }
+        float target = _plan_cruise;
+        float len = seg.exit == route::Trigger::Distance ? seg.arg : _seg_len[_seg_idx];
+        if (len > 0.0f && len - (_odom.distance() - _seg_dist0) <= _plan_brake_m) target = _plan_exit;
+        return _profile.update(target, limits(), LF_CTRL_DT);
+    }
+
+    void enterSegment(uint8_t idx) {
+        // 上一段实际走过的距离，下一圈据此在航点前减速
+        const RouteSegment* prev = (_drive_mode != 0) ? currentSegment() : nullptr;
+        if (prev != nullptr) _seg_len[_seg_idx] = _odom.distance() - _seg_dist0;
+
+        _seg_idx = idx;
+        const RouteSegment* seg = currentSegment();
+        bool terminal = seg == nullptr || seg->exit == route::Trigger::End;
+        uint32_t now = HAL_GetTick();
+        LapTimer_Segment(idx, seg ? (uint8_t)seg->drive : (uint8_t)route::Drive::Stop, terminal, now);
+
+        // 多圈 (route.laps)：闭合路线到终点不执行终点段，直接接下一圈的第一段
+        if (terminal && _laps_left > 1 && _route.count > 1) {
+            _laps_left--;
+            _seg_idx = 0;
+            seg = currentSegment();
+            LapTimer_Begin(_active_q, true, now);
+            LapTimer_Segment(0, (uint8_t)seg->drive, false, now);
+        }
 
-    void q2_enter(Q2State s) {
-        _q2_state = s;
-        _q2_prompted = false;
+        if (seg == nullptr) {
+            stopMotors();
+            return;
+        }
+        _seg_dist0 = _odom.distance();
+        _seg_yaw0  = User_YPR[0];
+        _seg_t0    = now;
+        _seg_cyc0  = DWT->CYCCNT;
+        _seg_settled = false;
+        planSegment();
+        if (prm::mp_enable && prm::mp_turn_slew > 0.0f && prev != nullptr && prev->drive != seg->drive) _diff_blend = true;
+
+        if (seg->actions & route::LockYaw) resetYawRef();
+        if (seg->actions & route::ResetTurnPid) _pidTurn.reset();
+        if (seg->drive == route::Drive::Stop) {
+            // 还在走：停车段按当前航向刹车，速度到 0 再断电 (见 updateISR)
+            if (prm::mp_enable && _profile.speed() > 0.0f) resetYawRef();
+            else stopMotors();
+        }
+        if (seg->actions & route::Prompt) Prompt::once(120);
+    }
+
+    // 距离 / 航向 / 时间条件在控制周期里检查
+    bool segmentDone(const RouteSegment& seg) const {
+        switch (seg.exit) {
+            case route::Trigger::Distance: return _odom.distance() - _seg_dist0 >= seg.arg;
+            case route::Trigger::Heading:  return std::fabs(wrapAngleDeg(User_YPR[0] - _seg_yaw0)) >= seg.arg;
+            case route::Trigger::Time:     return (float)(HAL_GetTick() - _seg_t0) >= seg.arg;
+            default:                       return false;
+        }
+    }
+
+    // ================== 航点边沿（EXTI 时间戳）==================
+    LineEdgeLog<LF_EDGE_LOG_LEN> _edges;
+    uint8_t  _active_q      = 0;
+    bool     _edge_has_line = false;  // EXTI 看到的原始 有线/无线
+    bool     _line_state    = false;  // 去抖后的 有线/无线
+    bool     _edge_pending  = false;  // 原始状态和去抖状态不同，等它保持 LF_EDGE_MIN_MS
+    uint32_t _edge_cyc      = 0;      // 待确认翻转的边沿时间
+    uint32_t _waypoint_cyc  = 0;      // 最近一次采纳的航点边沿时间
+    float    _waypoint_dist = 0.0f;   // 最近一次采纳航点时的里程
+
+    // 有线/无线翻转 (已去抖)：翻转保持够久后在下一个边沿中断或控制周期里推进路线
+    // 返回 true 表示该边沿被当前路段采纳
+    bool onLineEdge(bool rising) {
+        const RouteSegment* seg = currentSegment();
+        if (seg == nullptr) return false;
+        if (seg->exit != (rising ? route::Trigger::LineRise : route::Trigger::LineFall)) return false;
+        enterSegment(_seg_idx + 1);
+        return true;
+    }
+
+    // 去抖后的翻转：进段后 LF_EDGE_HOLDOFF_MS 以内的只更新状态，不推进路线
+    void commitLineEdge(bool has_line) {
+        const uint32_t holdoff = (SystemCoreClock / 1000U) * LF_EDGE_HOLDOFF_MS;
+        _edge_pending = false;
+        _line_state = has_line;
+        if (!_seg_settled && (int32_t)(_edge_cyc - _seg_cyc0) < (int32_t)holdoff) return;
+
+        if (onLineEdge(_line_state)) {
+            _seg_cyc0 = _edge_cyc;
+            _waypoint_cyc = _edge_cyc;
+            _waypoint_dist = _odom.distance();
+            CrashLog_Trace(TRACE_WAYPOINT, (uint16_t)(_active_q << 8 | _seg_idx));
+        }
+    }
+
+    // 消费边沿队列：传感器字之间的跳变只有 有线<->无线 才算航点边沿。
+    // 翻转后保持 LF_EDGE_MIN_MS 才确认 (时间仍记边沿时刻)，窗口内翻回去的整对丢掉；
+    // 确认在下一个边沿或下一个控制周期里做，最多晚一个控制周期
+    void processEdges() {
+        const uint32_t cyc_ms = SystemCoreClock / 1000U;
+        const uint32_t min_dur = cyc_ms * LF_EDGE_MIN_MS;
+        LineEdge e;
+        while (_edges.pop(e)) {
+            bool has_line = (e.raw != 0);
+            if (has_line == _edge_has_line) continue;
+            _edge_has_line = has_line;
+
+            if (_edge_pending) {
+                if (e.cyc - _edge_cyc < min_dur) {
+                    _edge_pending = false;  // 毛刺：又回到去抖状态
+                    continue;
+                }
+                commitLineEdge(!has_line);  // 上一个翻转已保持够久，先确认它
+            }
+            if (has_line != _line_state) {
+                _edge_pending = true;
+                _edge_cyc = e.cyc;
+            }
+        }
+
+        uint32_t now = DWT->CYCCNT;
+        if (_edge_pending && now - _edge_cyc >= min_dur) commitLineEdge(_edge_has_line);
+        // 屏蔽窗口起点之后的边沿到这时都已确认完，可以不再比较时间
+        if (!_seg_settled && (int32_t)(now - _seg_cyc0) >= (int32_t)(cyc_ms * (LF_EDGE_HOLDOFF_MS + LF_EDGE_MIN_MS))) {
+            _seg_settled = true;
+        }
+    }
+
+    // 五路传感器改为 上升/下降沿 EXTI 输入，DMA 读 IDR 不受影响
+    void beginEdgeIrq() {
+        GPIO_InitTypeDef GPIO_InitStruct = {0};
+        GPIO_InitStruct.Pin = LF_SENSOR_MASK;
+        GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
+        GPIO_InitStruct.Pull = GPIO_NOPULL;
+        HAL_GPIO_Init(LineSensors::port(), &GPIO_InitStruct);
+
+        _edge_has_line = (LineSensors::port()->IDR & LF_SENSOR_MASK) != 0;
+        _line_state = _edge_has_line;
+        _edge_pending = false;
+
+        // 与 TIM7 同抢占优先级：边沿处理和控制周期串行执行，状态机无需加锁
+        HAL_NVIC_SetPriority(EXTI9_5_IRQn, 1, 0);
+        HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
+        HAL_NVIC_SetPriority(EXTI15_10_IRQn, 1, 0);
+        HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
     }
 
 public:
-    LineFollower(TIM_HandleTypeDef* htim, uint32_t l1, uint32_t l2, uint32_t r1, uint32_t r2)
-        : _htim(htim), _ch_L1(l1), _ch_L2(l2), _ch_R1(r1), _ch_R2(r2),
+    LineFollower(TIM_HandleTypeDef* htim, uint32_t l1, uint32_t l2, uint32_t r1, uint32_t r2,
+                 TIM_HandleTypeDef* enc_l, TIM_HandleTypeDef* enc_r)
+        : _motor(htim, l1, l2, r2, r1), // 右电机镜像安装，正转时 R2 拉满
           _pidTurn(0.1f, 0.0f, 0.2f, -1.0f, 1.0f),
           _pidForward(1.0f, 0.0f, 0.0f, -1.0f, 1.0f),
-          _base_speed(0.0f)
+          _base_speed(0.0f),
+          _odom(enc_l, enc_r),
+          _wheels(enc_l, enc_r)
     {
-        _pwm_arr = 0;
+        _pidTurn.setDFilterAlpha(LF_TURN_D_ALPHA);
     }
 
     void begin() {
-        _pwm_arr = __HAL_TIM_GET_AUTORELOAD(_htim);
-        HAL_TIM_PWM_Start(_htim, _ch_L1);
-        HAL_TIM_PWM_Start(_htim, _ch_L2);
-        HAL_TIM_PWM_Start(_htim, _ch_R1);
-        HAL_TIM_PWM_Start(_htim, _ch_R2);
+        _motor.begin();
+
+        _sampler.begin();
+        beginEdgeIrq();
+        _odom.begin();
+        _wheels.begin();
     }
 
     void setBaseSpeed(float speed) { _base_speed = speed; }
@@ -159,136 +403,129 @@ public:
         _pidForward.reset();
     }
 
+    void setTurnDAlpha(float alpha) { _pidTurn.setDFilterAlpha(alpha); }
+
     void tunePid(uint8_t id, float kp, float ki, float kd) {
         if (id == PID_ID_TURN) _pidTurn.setTunings(kp, ki, kd);
         else if (id == PID_ID_FORWARD) _pidForward.setTunings(kp, ki, kd);
+        else if (id == PID_ID_WHEEL) _wheels.setTunings(kp, ki, kd);
     }
 
-    // 题号变化时复位（推荐你在 OnTimer 用 lastQ 调用；即使不调用也能跑，但更稳）
+    // 题号确认：取该题路线，从第一段开始 (第一段的进入动作，如 A 点提示 / 锁航向，立即执行)
     void onQuestionChanged(uint8_t q) {
-        if (q != 1) { _q1_state = Q1State::Idle; _q1_prompted = false; }
-        if (q != 2) { _q2_state = Q2State::Idle; _q2_prompted = false; }
+        _active_q = q;
+        stopMotors();
+        _route = Route_get(q);
+        _laps_left = (uint8_t)prm::route_laps;
+        for (float& len : _seg_len) len = 0.0f;
+        LapTimer_Begin(q, _route.count > 0, HAL_GetTick());
+        enterSegment(0);
     }
 
-    // Q2 显式启动：进第二题时在 A 点提示一次
-    void q2_start_from_A() {
-        // 你保证起跑 raw==0，所以 prev_hasLine=false 合理
-        _q2_prev_hasLine = false;
-        resetYawRef();
-        q2_enter(Q2State::Straight_AB);
-        // A 点提示一次
-        Prompt::once(120);
-        _q2_prompted = true;
+    // 当前路段下标 (== 段数表示走完)
+    uint8_t segmentIndex() const { return _seg_idx; }
+
+    // 最近一个控制周期的去抖传感器字 / 边沿时间
+    const LineSample& lineSample() const { return _sampler.last(); }
+
+    // 最近一次被状态机采纳的航点边沿时间 (DWT 周期)
+    uint32_t lastWaypointCyc() const { return _waypoint_cyc; }
+
+    // 上一个航点之后走过的距离 (m)，直线段可按距离做触发
+    float distanceSinceWaypoint() const { return _odom.distance() - _waypoint_dist; }
+
+    const Odometry& odometry() const { return _odom; }
+
+    const WheelSpeedLoop& wheels() const { return _wheels; }
+
+    // 运行时切换 开环 / 轮速闭环
+    void setClosedLoop(bool en) {
+        if (en == _closed_loop) return;
+        stopMotors();
+        _closed_loop = en;
+    }
+
+    // 本周期的黑匣子快照 (TIM7 里 updateISR 之后调用)
+    void snapshot(BlackBoxSample& s) const {
+        s.t_ms     = HAL_GetTick();
+        s.sensor   = _sampler.last().raw & LF_SENSOR_MASK;
+        s.question = _active_q;
+        s.state    = _seg_idx;
+        s.mode     = _drive_mode;
+        s.flags    = _closed_loop ? 0x01 : 0x00;
+        s.duty_l   = toQ4(_motor.left());
+        s.duty_r   = toQ4(_motor.right());
+        s.speed_l  = (int16_t)(_wheels.speedLeft() * 1000.0f);
+        s.speed_r  = (int16_t)(_wheels.speedRight() * 1000.0f);
+        s.gyro_z   = (int16_t)(User_Rates[2] * 100.0f);
+        s.yaw      = User_YPR[0];
+        if (_drive_mode == 1) {
+            s.pid_p = toQ4(_pidForward.pTerm());
+            s.pid_i = toQ4(_pidForward.iTerm());
+            s.pid_d = toQ4(_pidForward.dTerm());
+        } else {
+            s.pid_p = toQ4(_pidTurn.pTerm());
+            s.pid_i = toQ4(_pidTurn.iTerm());
+            s.pid_d = toQ4(_pidTurn.dTerm());
+        }
+    }
+
+    // ===== 编码器 A 相 EXTI 入口 =====
+    bool onEncoderEdgeISR(uint16_t pin) { return _wheels.onEncoderEdge(pin); }
+
+    // ===== 1kHz 内环入口 (TIM17，抢占 TIM7/EXTI) =====
+    void speedLoopISR() {
+        float duty_l, duty_r;
+        _wheels.update(duty_l, duty_r);
+        if (!_closed_loop) return;
+        _motor.set(duty_l, duty_r);
+    }
+
+    // ===== EXTI 边沿入口：与 TIM7 同优先级，不会和 updateISR 互相打断 =====
+    void onEdgeISR() {
+        LineEdge e{DWT->CYCCNT, static_cast<uint16_t>(LineSensors::port()->IDR & LF_SENSOR_MASK)};
+        _edges.push(e);
+        processEdges();
     }
 
     // ===== ISR 主逻辑 =====
-    void updateISR(uint8_t conformedQuestion) {
-        uint16_t raw = (GPIOA->IDR) & LF_SENSOR_MASK;
-        bool hasLine = (raw != 0);
-
-        switch (conformedQuestion) {
-            case 1: { // Q1: A->B，到B停下并提示一次（状态机）
-                bool rising = (!_q1_prev_hasLine) && hasLine; // 无线->有线 到B
-
-                switch (_q1_state) {
-                    case Q1State::Idle:
-                        setBaseSpeed(0.10f);
-                        resetYawRef();
-                        q1_enter(Q1State::GoStraight_AB);
-                        break;
-
-                    case Q1State::GoStraight_AB:
-                        setBaseSpeed(0.10f);
-                        // 直线段：航向保持
-                        driveStraightYawHold();
-                        if (rising) {
-                            q1_enter(Q1State::StopAtB);
-                        }
-                        break;
-
-                    case Q1State::StopAtB:
-                        setSingleMotor(_ch_L1, _ch_L2, 0.0f);
-                        setSingleMotor(_ch_R1, _ch_R2, 0.0f);
-
-                        if (!_q1_prompted) {
-                            Prompt::once(120);
-                            _q1_prompted = true;
-                        }
-                        break;
-                }
+    // 路线在 onQuestionChanged 里已经取好，这里只解释当前段
+    void updateISR() {
+        _odom.update(User_YPR[0]);
+        processEdges();
+
+        // 20kHz 采样去抖后的传感器字，只用于循线误差；航点切换由 EXTI 边沿驱动
+        const LineSample& sample = _sampler.update();
+        uint16_t raw = sample.raw & LF_SENSOR_MASK;
+
+        const RouteSegment* seg = currentSegment();
+        if (seg == nullptr) return; // 没有路线 / 已走完：不开车
+
+        if (segmentDone(*seg)) {
+            enterSegment(_seg_idx + 1);
+            CrashLog_Trace(TRACE_WAYPOINT, (uint16_t)(_active_q << 8 | _seg_idx));
+            seg = currentSegment();
+            if (seg == nullptr) return;
+        }
 
-                _q1_prev_hasLine = hasLine;
+        switch (seg->drive) {
+            case route::Drive::YawHold:
+                setBaseSpeed(profiledSpeed(*seg));
+                driveStraightYawHold();
                 break;
-            }
 
-            case 2: { // Q2: A->B->C->D->A，每过点提示一次（状态机）
-                // 边沿
-                bool rising  = (!_q2_prev_hasLine) && hasLine;      // 无线->有线：B 或 D
-                bool falling = (_q2_prev_hasLine) && (!hasLine);    // 有线->无线：C 或 A
-
-                switch (_q2_state) {
-                    case Q2State::Idle:
-                        // 兜底启动（如果你在外层已经调用 q2_start_from_A()，这里不会走）
-                        q2_start_from_A();
-                        break;
-
-                    case Q2State::Straight_AB:
-                        setBaseSpeed(0.10f);
-                        driveStraightYawHold();
-
-                        if (rising) { // 到 B
-                            Prompt::once(120);
-                            _pidTurn.reset();
-                            q2_enter(Q2State::Arc_BC);
-                        }
-                        break;
-
-                    case Q2State::Arc_BC:
-                        setBaseSpeed(0.10f);
-                        driveArcLineFollow(raw);
-
-                        if (falling) { // 到 C
-                            Prompt::once(120);
-                            resetYawRef(); // 进入直线前重新锁航向
-                            q2_enter(Q2State::Straight_CD);
-                        }
-                        break;
-
-                    case Q2State::Straight_CD:
-                        setBaseSpeed(0.10f);
-                        driveStraightYawHold();
-
-                        if (rising) { // 到 D
-                            Prompt::once(120);
-                            _pidTurn.reset();
-                            q2_enter(Q2State::Arc_DA);
-                        }
-                        break;
-
-                    case Q2State::Arc_DA:
-                        setBaseSpeed(0.10f);
-                        driveArcLineFollow(raw);
-
-                        if (falling) { // 回到 A
-                            Prompt::once(120);
-                            q2_enter(Q2State::Done);
-                        }
-                        break;
-
-                    case Q2State::Done:
-                        setSingleMotor(_ch_L1, _ch_L2, 0.0f);
-                        setSingleMotor(_ch_R1, _ch_R2, 0.0f);
-                        break;
-                }
-
-                _q2_prev_hasLine = hasLine;
+            case route::Drive::LineFollow:
+                setBaseSpeed(profiledSpeed(*seg));
+                driveArcLineFollow(raw);
                 break;
-            }
 
-            default:
-                // 非1/2：不开车（或你想保留原case3/4逻辑可在这里继续写）
-                _q1_prev_hasLine = hasLine;
-                _q2_prev_hasLine = hasLine;
+            case route::Drive::Stop:
+                if (prm::mp_enable && _profile.speed() > 0.0f) {
+                    setBaseSpeed(_profile.update(0.0f, limits(), LF_CTRL_DT));
+                    driveStraightYawHold();
+                } else {
+                    stopMotors();
+                }
                 break;
         }
     }
@@ -301,6 +538,8 @@ void LineFollower_Init(void);
 void LineFollower_OnTimer(void);
 void LineFollower_SetSpeed(float speed);
 void LineFollower_SetPID(float kp, float ki, float kd);
+void LineFollower_OnEdge(uint16_t pin);
+void LineFollower_OnSpeedLoop(void);
 #ifdef __cplusplus
 }
 #endif
@@ -1,6 +1,9 @@
 #ifndef LINE_FOLLOWER_INTERFACE_H
 #define LINE_FOLLOWER_INTERFACE_H
 
+#include <stdint.h>
+#include <stdbool.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -9,6 +12,8 @@ extern "C" {
     void LineFollower_Init(void);
     void LineFollower_OnTimer(void);
     void LineFollower_SetSpeed(float speed);
+    void LineFollower_OnEdge(uint16_t pin);  // 传感器 EXTI 回调
+    void LineFollower_OnSpeedLoop(void);     // TIM17 1kHz 轮速内环
 
 
 #ifdef __cplusplus
@@ -18,5 +23,10 @@ extern "C" {
 void LineFollower_SetPID(uint8_t id, float kp, float ki, float kd);
 void LineFollower_SetYaw();
 void LineFollower_SetYawRef(float yaw_deg);
+void LineFollower_SetTurnDAlpha(float alpha);
+void LineFollower_SetClosedLoop(bool en);
+
+struct OdomPose;
+void LineFollower_GetPose(struct OdomPose* out);
 
 #endif // LINE_FOLLOWER_INTERFACE_H
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "main.h"
+#include "SensorArray.hpp"
+#include <array>
+#include <cstdint>
+
+// ================== 配置参数 ==================
+#define LS_SAMPLE_RATE_HZ  20000U  // TIM6 触发 DMA 搬运 GPIOA->IDR 的频率
+#define LS_BUF_LEN         1024U   // DMA 环形缓冲点数 (20ms 控制周期约 400 点)
+#define LS_MAJORITY_WIN    16U     // 多数表决窗口 (16 点 = 0.8ms)
+
+// 单个控制周期的采样结果
+struct LineSample {
+    uint16_t raw;        // 去抖后的传感器字，格式同 IDR & LineSensors::mask
+    bool     rose;       // 本周期内出现过 无线->有线
+    bool     fell;       // 本周期内出现过 有线->无线
+    uint32_t stamp_cyc;  // raw 对应的时刻 (DWT 周期)
+    uint32_t edge_cyc;   // 最近一次 有线/无线 翻转的时刻 (DWT 周期)
+};
+
+namespace line_sampler_detail {
+
+// 每路 6bit: 窗口内最多 16 个 1，不会向相邻通道进位
+constexpr uint32_t LANE_BITS = 6;
+constexpr uint32_t LANE_NUM  = LineSensors::count;
+// 每路加上偏置后，计数 > WIN/2 时通道最高位 (bit5) 置 1
+constexpr uint32_t LANE_BIAS = 32U - (LS_MAJORITY_WIN / 2U + 1U);
+
+static_assert(LS_MAJORITY_WIN + LANE_BIAS < (1U << LANE_BITS), "lane overflow");
+static_assert(LANE_NUM * LANE_BITS <= 32U, "too many sensors for one SWAR word");
+static_assert(LS_BUF_LEN > 2U * (LS_SAMPLE_RATE_HZ / 50U), "buffer too short for a 20ms tick");
+
+// 查表只用端口值的一个字节，所有传感器引脚需落在同一字节内
+constexpr uint32_t BYTE_SHIFT = (LineSensors::mask & 0x00FFU) ? 0U : 8U;
+static_assert(((LineSensors::mask >> BYTE_SHIFT) & ~0xFFU) == 0, "sensor pins must share one byte of the port");
+
+constexpr uint32_t repeatLanes(uint32_t v) {
+    uint32_t r = 0;
+    for (uint32_t k = 0; k < LANE_NUM; k++) r |= v << (k * LANE_BITS);
+    return r;
+}
+
+constexpr uint32_t BIAS_ALL = repeatLanes(LANE_BIAS);
+constexpr uint32_t MSB_ALL  = repeatLanes(1U << (LANE_BITS - 1U));
+
+// 端口值中传感器所在字节 -> 各路计数通道 +1 的 SWAR 字 (通道 k = 第 k 路传感器)
+constexpr std::array<uint32_t, 256> makeSpreadLut() {
+    std::array<uint32_t, 256> lut{};
+    for (uint32_t b = 0; b < 256; b++) {
+        uint32_t w = 0;
+        for (uint32_t k = 0; k < LANE_NUM; k++) {
+            if ((static_cast<uint32_t>(LineSensors::pins[k]) >> BYTE_SHIFT) & b) w |= 1U << (k * LANE_BITS);
+        }
+        lut[b] = w;
+    }
+    return lut;
+}
+
+inline constexpr std::array<uint32_t, 256> SPREAD_LUT = makeSpreadLut();
+
+inline uint32_t spread(uint16_t idr) { return SPREAD_LUT[(idr >> BYTE_SHIFT) & 0xFFU]; }
+
+} // namespace line_sampler_detail
+
+/*
+ * LineSampler
+ * TIM6 更新事件触发 DMA1_Stream1，把传感器端口 IDR 连续搬进环形缓冲，CPU 零开销。
+ * 控制周期里 update() 把新到的采样点过一遍滑动窗口多数表决：
+ * 每路传感器各占 uint32 里的一个 6bit 计数通道 (SWAR)，
+ * 每个采样点只有一次查表 + 一次加减，就能同时更新所有计数。
+ */
+class LineSampler {
+public:
+    LineSampler() = default;
+
+    // 配置 TIM6 + DMA 并开始采样
+    void begin();
+
+    // 控制周期调用：消费新采样点，返回去抖后的传感器字和边沿时间
+    const LineSample& update();
+
+    const LineSample& last() const { return _out; }
+
+private:
+    void resync(uint32_t head);
+
+    TIM_HandleTypeDef _htim{};
+    DMA_HandleTypeDef _hdma{};
+
+    uint32_t _tail = 0;          // 下一个待处理的采样点
+    uint32_t _sum  = 0;          // 五路窗口计数 (SWAR)
+    uint32_t _maj  = 0;          // 当前多数表决结果 (各通道 MSB)
+    uint32_t _cyc_per_sample = 0;
+
+    LineSample _out{};
+};
@@ -0,0 +1,32 @@
+#ifndef MEM_WATCH_H
+#define MEM_WATCH_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ================== 配置参数 ==================
+#define MEMWATCH_PAINT_WORD    0xA5A5A5A5U  // 栈涂色值
+#define MEMWATCH_SCAN_MS       1000U        // 主循环水位扫描周期
+#define MEMWATCH_WARN_GAP      2048U        // 堆顶与栈最深处之间少于这么多字节时 RTT 告警
+#define MEMWATCH_ISR_SAMPLE    1            // 1: TIM17 (1kHz，最高优先级) 里采样 MSP 深度
+
+    // main() 最开头调用：把堆顶到当前 SP 之间涂成 MEMWATCH_PAINT_WORD
+    void MemWatch_PaintStack(void);
+
+    // 主循环调用，内部按 MEMWATCH_SCAN_MS 限频扫描栈水位
+    void MemWatch_Poll(uint32_t now_ms);
+
+    // TIM17 中断里调用：记录中断上下文看到的最深 MSP
+    void MemWatch_SampleIsr(void);
+
+    // 串口 "MEM"：栈 / 堆 / 分配计数报告发到 USART3
+    void MemWatch_Report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MEM_WATCH_H
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cmath>
+
+/*
+ * 限加加速度 (S 曲线) 速度规划
+ * 速度设定值不再阶跃：加速度以 jerk 为斜率爬到 acc (附着力上限) 再降回 0，
+ * 到目标速度时加速度正好回到 0。单位自洽即可 (LineFollower 里用占空比 / s)。
+ */
+struct MotionLimits {
+    float acc;    // 最大加速度
+    float jerk;   // 最大加加速度
+};
+
+class SCurve {
+public:
+    // 每个控制周期调用一次，返回本周期的速度设定值
+    float update(float target, const MotionLimits& m, float dt) {
+        float e = target - _v;
+        if (e == 0.0f && _a == 0.0f) return _v;
+
+        // 以 jerk 把加速度降到 0 期间速度还会再变 a²/(2j)：按剩余速度差反推现在允许的加速度
+        float a_des = std::sqrt(2.0f * m.jerk * std::fabs(e));
+        if (a_des > m.acc) a_des = m.acc;
+        if (e < 0.0f) a_des = -a_des;
+
+        float da = m.jerk * dt;
+        if (a_des > _a + da) a_des = _a + da;
+        if (a_des < _a - da) a_des = _a - da;
+        _a = a_des;
+        _v += _a * dt;
+
+        // 离散步长带来的越过：直接落到目标上
+        if ((e > 0.0f && _v >= target) || (e < 0.0f && _v <= target)) {
+            _v = target;
+            _a = 0.0f;
+        }
+        return _v;
+    }
+
+    // 不做规划时直接跟随 (保持状态连续，重新打开规划时不跳变)
+    void set(float v) {
+        _v = v;
+        _a = 0.0f;
+    }
+
+    void reset() { set(0.0f); }
+
+    float speed() const { return _v; }
+
+private:
+    float _v = 0.0f;
+    float _a = 0.0f;
+};
+
+/*
+ * 从 v0 按 S 曲线减到 v1 需要的距离 (v0 <= v1 时为 0)
+ * 速度差够大时是 梯形加速度 (jerk 爬坡 - acc 平台 - jerk 回落)，否则是三角形；
+ * 两种情况速度曲线都关于中点对称，平均速度 = (v0 + v1) / 2。
+ */
+inline float SCurve_brakeDistance(float v0, float v1, const MotionLimits& m) {
+    float dv = v0 - v1;
+    if (dv <= 0.0f) return 0.0f;
+    float t = (dv >= m.acc * m.acc / m.jerk) ? dv / m.acc + m.acc / m.jerk
+                                            : 2.0f * std::sqrt(dv / m.jerk);
+    return 0.5f * (v0 + v1) * t;
+}
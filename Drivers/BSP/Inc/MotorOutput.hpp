@@ -0,0 +1,43 @@
+#pragma once
+
+#include "main.h"
+#include <cstdint>
+
+/*
+ * MotorOutput
+ * TIM1 CH1~CH4 双 H 桥输出级。四个比较值先算好放进 burst 缓冲，
+ * 再由 TIM1 更新事件触发 DMA1_Stream2 经 DMAR/DCR 一次写完 CCR1~CCR4；
+ * CCR 预装载打开，新值在下一个更新事件同时生效，左右轮永远在同一个 PWM 边沿切换。
+ * 任何上下文 (TIM17 内环 / TIM7 外环 / EXTI 停车) 都只走 set()，写入顺序统一。
+ */
+class MotorOutput {
+public:
+    // 每个轮子一对通道：speed > 0 时 a 拉满、b 出占空比 (与原 setSingleMotor 的 ch1/ch2 相同)
+    MotorOutput(TIM_HandleTypeDef* htim, uint32_t left_a, uint32_t left_b,
+                uint32_t right_a, uint32_t right_b)
+        : _htim(htim), _l_a(left_a), _l_b(left_b), _r_a(right_a), _r_b(right_b) {}
+
+    // 启动 PWM，配置 DMA burst；先提交一次全停
+    void begin();
+
+    // 左右速度 [-1, 1]，下一个 PWM 周期起同时生效
+    void set(float left, float right);
+
+    void stop() { set(0.0f, 0.0f); }
+
+    // 最近一次 set() 的左右速度 (限幅后)
+    float left() const { return _left; }
+    float right() const { return _right; }
+
+private:
+    void fill(uint32_t* ccr, uint32_t ch_a, uint32_t ch_b, float speed) const;
+    void commit(const uint32_t* ccr);
+
+    TIM_HandleTypeDef* _htim;
+    uint32_t _l_a, _l_b;
+    uint32_t _r_a, _r_b;
+    uint32_t _arr = 0;
+    volatile float _left = 0.0f, _right = 0.0f;
+
+    DMA_HandleTypeDef _hdma{};
+};
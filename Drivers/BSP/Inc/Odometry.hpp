@@ -0,0 +1,164 @@
+#pragma once
+
+#include "main.h"
+#include <cmath>
+#include <cstdint>
+
+// ================== 配置参数 (按实际底盘修改) ==================
+#define ODOM_COUNTS_PER_REV   780.0f   // 轮子转一圈的编码器计数 (TI1 模式: 2 x 线数 x 减速比)
+#define ODOM_WHEEL_DIAM_M     0.065f   // 轮径
+#define ODOM_TRACK_M          0.150f   // 左右轮距
+#define ODOM_LEFT_DIR         1        // 前进时计数方向 (+1 / -1)
+#define ODOM_RIGHT_DIR        (-1)     // 右轮镜像安装，前进时计数递减
+#define ODOM_IMU_YAW_SIGN     (-1.0f)  // IMU yaw 正方向与里程计 θ (逆时针为正) 的关系
+#define ODOM_IMU_WEIGHT       0.05f    // 每周期向 IMU 航向收敛的比例 (0 = 纯编码器)
+
+// 编码器计数差分：按自动重装值判断 16/32 位，截断成对应位宽的有符号数即处理了回绕
+inline int32_t encoderCountDiff(TIM_HandleTypeDef* htim, uint32_t now, uint32_t before) {
+    uint32_t diff = now - before;
+    if (__HAL_TIM_GET_AUTORELOAD(htim) <= 0xFFFFU) {
+        return (int32_t)(int16_t)(uint16_t)diff;
+    }
+    return (int32_t)diff;
+}
+
+inline int32_t encoderDelta(TIM_HandleTypeDef* htim, uint32_t& last) {
+    uint32_t cnt = __HAL_TIM_GET_COUNTER(htim);
+    int32_t d = encoderCountDiff(htim, cnt, last);
+    last = cnt;
+    return d;
+}
+
+// 每个编码器计数对应的轮面行程 (m)
+constexpr float ODOM_M_PER_COUNT = 3.14159265f * ODOM_WHEEL_DIAM_M / ODOM_COUNTS_PER_REV;
+
+// 位姿快照：x/y 为起点坐标系 (米)，theta 逆时针为正 (度)
+struct OdomPose {
+    float x;
+    float y;
+    float theta_deg;
+    float v_left;      // 左轮线速度 m/s
+    float v_right;     // 右轮线速度 m/s
+    float distance;    // 累计行驶距离 (前进为正) m
+    uint32_t stamp_cyc;
+};
+
+/*
+ * Odometry
+ * 读取 TIM2 (左轮, 32bit) / TIM3 (右轮, 16bit) 编码器计数，
+ * 按计数器位宽做有符号差分处理回绕；编码器航向与 IMU yaw 互补融合后
+ * 积分出 (x, y, θ)。控制周期 (TIM7) 写，主循环用 snapshot() 读 (seqlock)。
+ */
+class Odometry {
+public:
+    Odometry(TIM_HandleTypeDef* left, TIM_HandleTypeDef* right)
+        : _enc_l(left), _enc_r(right) {}
+
+    void begin() {
+        HAL_TIM_Encoder_Start(_enc_l, TIM_CHANNEL_ALL);
+        HAL_TIM_Encoder_Start(_enc_r, TIM_CHANNEL_ALL);
+        _last_l = __HAL_TIM_GET_COUNTER(_enc_l);
+        _last_r = __HAL_TIM_GET_COUNTER(_enc_r);
+        _last_cyc = DWT->CYCCNT;
+        _inited = false;
+    }
+
+    // 位姿清零 (以当前 IMU yaw 为 θ=0)
+    void reset(float imu_yaw_deg) {
+        _x = _y = _theta = 0.0f;
+        _distance = 0.0f;
+        _imu_yaw0 = imu_yaw_deg;
+        _inited = true;
+        publish(DWT->CYCCNT);
+    }
+
+    // 控制周期调用
+    void update(float imu_yaw_deg) {
+        uint32_t now = DWT->CYCCNT;
+        float dt = (float)(now - _last_cyc) / (float)SystemCoreClock;
+        _last_cyc = now;
+
+        int32_t dl = ODOM_LEFT_DIR  * encoderDelta(_enc_l, _last_l);
+        int32_t dr = ODOM_RIGHT_DIR * encoderDelta(_enc_r, _last_r);
+
+        if (!_inited) reset(imu_yaw_deg);
+
+        float sl = (float)dl * ODOM_M_PER_COUNT;
+        float sr = (float)dr * ODOM_M_PER_COUNT;
+        float ds = 0.5f * (sl + sr);
+        float dtheta = (sr - sl) / ODOM_TRACK_M;
+
+        // 中点航向积分位置
+        float theta_mid = _theta + 0.5f * dtheta;
+        _x += ds * cosf(theta_mid);
+        _y += ds * sinf(theta_mid);
+        _theta = wrapRad(_theta + dtheta);
+
+        // 互补融合：编码器短期准，IMU 不受打滑影响
+        float imu_theta = ODOM_IMU_YAW_SIGN * (imu_yaw_deg - _imu_yaw0) * DEG2RAD;
+        _theta = wrapRad(_theta + ODOM_IMU_WEIGHT * wrapRad(imu_theta - _theta));
+
+        _distance += ds;
+        if (dt > 0.0f) {
+            _v_l = sl / dt;
+            _v_r = sr / dt;
+        }
+
+        publish(now);
+    }
+
+    // 控制周期内直接读 (与 update 同一上下文)
+    float distance() const { return _distance; }
+    float speedLeft() const { return _v_l; }
+    float speedRight() const { return _v_r; }
+
+    // 其他上下文读一致的快照
+    OdomPose snapshot() const {
+        OdomPose p;
+        uint32_t seq;
+        do {
+            seq = _seq;
+            __DMB();
+            p = _pub;
+            __DMB();
+        } while ((seq & 1U) || seq != _seq);
+        return p;
+    }
+
+private:
+    static constexpr float DEG2RAD = (float)M_PI / 180.0f;
+
+    static float wrapRad(float a) {
+        while (a >  (float)M_PI) a -= 2.0f * (float)M_PI;
+        while (a < -(float)M_PI) a += 2.0f * (float)M_PI;
+        return a;
+    }
+
+    void publish(uint32_t stamp) {
+        _seq = _seq + 1U;
+        __DMB();
+        _pub.x = _x;
+        _pub.y = _y;
+        _pub.theta_deg = _theta / DEG2RAD;
+        _pub.v_left = _v_l;
+        _pub.v_right = _v_r;
+        _pub.distance = _distance;
+        _pub.stamp_cyc = stamp;
+        __DMB();
+        _seq = _seq + 1U;
+    }
+
+    TIM_HandleTypeDef* _enc_l;
+    TIM_HandleTypeDef* _enc_r;
+    uint32_t _last_l = 0, _last_r = 0;
+    uint32_t _last_cyc = 0;
+    bool _inited = false;
+
+    float _x = 0.0f, _y = 0.0f, _theta = 0.0f;
+    float _distance = 0.0f;
+    float _v_l = 0.0f, _v_r = 0.0f;
+    float _imu_yaw0 = 0.0f;
+
+    volatile uint32_t _seq = 0;
+    OdomPose _pub{};
+};
@@ -0,0 +1,106 @@
+#pragma once
+#include "W25Q64.hpp"
+#include "Params.hpp"
+#include <cstring>
+
+#include "SEGGER_RTT.h"
+
+// 参数表放在崩溃现场 (0x7FD000) 下面一个扇区；旧的 PID 扇区 (0x7FF000) 只在首次迁移时读
+#define PARAM_FLASH_ADDR  0x7FC000
+#define PARAM_MAGIC       0x314D5250U // "PRM1"
+#define PARAM_PAGE        256U
+
+/*
+ * 格式：头 + 条目 {名字哈希, 值}，条目按名字哈希认领，
+ * 增删参数 / 调整表顺序后旧数据仍能对上，认不出的条目忽略，没存的参数保持默认值。
+ */
+struct ParamFlashHeader {
+    uint32_t magic;
+    uint16_t count;
+    uint16_t reserved;
+    uint32_t sum;       // 条目逐字节累加和
+};
+
+struct ParamFlashEntry {
+    uint32_t name_hash; // param::hash(name, 0)
+    float    value;
+};
+
+static_assert(PARAM_PAGE % sizeof(ParamFlashEntry) == 0, "page must hold whole entries");
+
+class ParamStorage {
+private:
+    W25Q64& _flash;
+    uint32_t _addr;
+    uint8_t _page[PARAM_PAGE];
+
+    static constexpr uint32_t ENTRY_BASE = PARAM_PAGE; // 头单独占第一页，条目从第二页开始
+    static constexpr uint32_t PER_PAGE = PARAM_PAGE / sizeof(ParamFlashEntry);
+    static constexpr uint32_t MAX_ENTRIES = (4096 - ENTRY_BASE) / sizeof(ParamFlashEntry);
+
+    // 逐页读条目，apply 为 false 时只算累加和
+    uint32_t walk(uint16_t count, bool apply) {
+        uint32_t sum = 0;
+        uint32_t addr = _addr + ENTRY_BASE;
+        for (uint32_t left = count; left > 0;) {
+            uint32_t k = left < PER_PAGE ? left : PER_PAGE;
+            _flash.readData(addr, _page, k * sizeof(ParamFlashEntry));
+            for (uint32_t i = 0; i < k * sizeof(ParamFlashEntry); i++) sum += _page[i];
+            if (apply) {
+                const ParamFlashEntry* e = (const ParamFlashEntry*)_page;
+                for (uint32_t i = 0; i < k; i++) {
+                    int idx = Param_findHash(e[i].name_hash);
+                    if (idx >= 0 && (Param_desc(idx).flags & param::Persist)) Param_set(idx, e[i].value, false);
+                }
+            }
+            addr += PARAM_PAGE;
+            left -= k;
+        }
+        return sum;
+    }
+
+public:
+    ParamStorage(W25Q64& f, uint32_t addr = PARAM_FLASH_ADDR) : _flash(f), _addr(addr) {}
+
+    // 上电：校验通过才覆盖默认值 (只写变量不调回调，最后由调用方 Param_applyAll)
+    bool load() {
+        ParamFlashHeader h{};
+        _flash.readData(_addr, (uint8_t*)&h, sizeof(h));
+        if (h.magic != PARAM_MAGIC || h.count > MAX_ENTRIES) return false;
+        if (walk(h.count, false) != h.sum) {
+            RTT_Log("[Param] checksum mismatch, using defaults\r\n");
+            return false;
+        }
+        walk(h.count, true);
+        return true;
+    }
+
+    // 写所有带 Persist 标志的参数 (擦一次扇区约 50ms + 每页约 1ms)
+    void save() {
+        _flash.eraseSector(_addr);
+
+        uint16_t count = 0;
+        uint32_t sum = 0;
+        uint32_t fill = 0;
+        uint32_t addr = _addr + ENTRY_BASE;
+        for (int i = 0; i < Param_count(); i++) {
+            const param::Desc& d = Param_desc(i);
+            if (!(d.flags & param::Persist)) continue;
+            ParamFlashEntry e{param::hash(d.name, 0), Param_get(i)};
+            std::memcpy(&_page[fill], &e, sizeof(e));
+            for (uint32_t b = 0; b < sizeof(e); b++) sum += _page[fill + b];
+            fill += sizeof(e);
+            count++;
+            if (fill == PARAM_PAGE) {
+                _flash.writePage(addr, _page, PARAM_PAGE);
+                addr += PARAM_PAGE;
+                fill = 0;
+            }
+        }
+        if (fill > 0) _flash.writePage(addr, _page, fill);
+
+        // 头最后写：中途掉电时 magic 仍是 0xFF，下次上电按默认值
+        ParamFlashHeader h{PARAM_MAGIC, count, 0, sum};
+        _flash.writePage(_addr, (uint8_t*)&h, sizeof(h));
+    }
+};
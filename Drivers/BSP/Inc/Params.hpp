@@ -0,0 +1,138 @@
+#pragma once
+
+#include "GainSchedule.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * 运行时参数表
+ * 每个参数就是一个普通全局变量 (prm::xxx)，热路径直接读，不经过查表；
+ * 名字、类型、范围、默认值、是否落盘、修改后回调登记在 Params.cpp 的 kParams 里。
+ * 串口 SET/GET、Flash 保存 (ParamStorage.hpp)、OLED 编辑都走 名字 -> 下标 -> Param_set/get 这一条路径，
+ * 名字到下标是编译期生成的完美哈希：一次哈希 + 一次混合 + 一次 strcmp。
+ */
+namespace param {
+
+enum class Type : uint8_t { Float, Int, Bool };
+
+enum : uint8_t {
+    Persist = 0x01,   // SAVE 时写进 Flash
+};
+
+struct Desc {
+    const char* name;
+    Type        type;
+    void*       ptr;     // float / int32_t / bool 变量
+    float       min, max, def, step;
+    uint8_t     flags;
+    void (*apply)();     // 修改后调用 (可为空)：推给不直接读变量的模块
+};
+
+// FNV-1a；seed 为 0 时就是 Flash 里认参数用的名字哈希
+constexpr uint32_t hash(const char* s, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed;
+    while (*s) {
+        h ^= static_cast<uint8_t>(*s++);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// 槽数取不小于 4N 的 2 的幂：N = 50 时平均约 200 个种子就能找到，编译期开销可以忽略
+constexpr size_t tableSize(size_t n) {
+    size_t m = 1;
+    while (m < 4 * n) m <<= 1;
+    return m;
+}
+
+constexpr unsigned slotBits(size_t m) {
+    unsigned b = 0;
+    while ((size_t(1) << b) < m) b++;
+    return b;
+}
+
+/*
+ * 槽号：名字哈希和种子做一次雪崩混合 (murmur3 fmix32)，取高 bits 位。
+ * 不能只把种子异或进 FNV 初值再取低位：FNV-1a 结果的低 k 位只取决于初值的低 k 位和输入，
+ * 换多少个种子都只有 M 种分法。
+ */
+constexpr uint32_t slotOf(uint32_t name_hash, uint32_t seed, unsigned bits) {
+    uint32_t h = name_hash ^ (seed * 0x9E3779B9u);
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h >> (32 - bits);
+}
+
+template <size_t M>
+struct PerfectHash {
+    static_assert(M >= 2 && (M & (M - 1)) == 0, "slot count must be a power of two");
+    static constexpr unsigned bits = slotBits(M);
+    uint32_t seed;
+    std::array<uint8_t, M> slot;   // 0xFF 为空
+
+    // 名字 -> 候选下标 (0xFF: 不在表里)，调用方再 strcmp 确认
+    uint8_t lookup(const char* name) const { return slot[slotOf(hash(name, 0), seed, bits)]; }
+};
+
+// 编译期逐个试种子，直到 N 个名字落到互不相同的槽；找不到时 seed 为 0
+template <size_t M, size_t N>
+constexpr PerfectHash<M> buildPerfectHash(const std::array<Desc, N>& d) {
+    static_assert(N < 0xFF, "too many parameters for uint8_t slots");
+    std::array<uint32_t, N> h{};
+    for (size_t i = 0; i < N; i++) h[i] = hash(d[i].name, 0);
+
+    for (uint32_t seed = 1; seed < 100000u; seed++) {
+        PerfectHash<M> ph{seed, {}};
+        for (auto& s : ph.slot) s = 0xFF;
+        bool ok = true;
+        for (size_t i = 0; i < N && ok; i++) {
+            uint32_t k = slotOf(h[i], seed, PerfectHash<M>::bits);
+            if (ph.slot[k] != 0xFF) ok = false;
+            else ph.slot[k] = static_cast<uint8_t>(i);
+        }
+        if (ok) return ph;
+    }
+    return PerfectHash<M>{0, {}};
+}
+
+} // namespace param
+
+// ================== 参数变量 (热路径直接读) ==================
+namespace prm {
+extern float   lpid_p, lpid_i, lpid_d;      // 循线 PID
+extern float   fpid_p, fpid_i, fpid_d;      // 航向保持 PID
+extern float   wpid_p, wpid_i, wpid_d;      // 轮速内环 PI
+extern float   speed_straight;              // 直线段基础速度 (满占空比 = 1)
+extern float   speed_arc;                   // 循线段基础速度
+extern float   turn_d_alpha;                // 循线 PID 微分低通系数
+extern bool    speed_loop;                  // 轮速内环闭环
+extern int32_t line_w[5];                   // 传感器权重 (从左到右)
+extern int32_t route_laps;                  // 闭合路线连续跑的圈数
+extern bool    ilc_enable;                  // 分段速度迭代学习 (SpeedLearner.hpp)
+extern float   ilc_err_line, ilc_err_yaw;   // 误差峰值上限：循线段 (权重单位) / 航向保持段 (°)
+extern float   ilc_sat_frac;                // 外环饱和时间占比上限
+extern float   ilc_step, ilc_backoff;       // 每圈加速量 / 超限退回系数
+extern float   ilc_vmin, ilc_vmax;          // 学习速度范围
+extern bool    gs_enable;                   // PID 增益调度 (GainSchedule.hpp)
+extern float   gs_v[GS_POINTS];             // 调度断点速度，gs_v[0] 对应 lpid.* / fpid.*
+extern PidGains lpid_gs[GS_POINTS - 1];     // 循线 PID 在 gs_v[1..] 的增益 (负值跟随 lpid_*)
+extern PidGains fpid_gs[GS_POINTS - 1];     // 航向保持 PID 在 gs_v[1..] 的增益 (负值跟随 fpid_*)
+extern bool    mp_enable;                   // S 曲线速度规划 (MotionProfile.hpp)
+extern float   mp_acc, mp_jerk;             // 附着力上限：最大加速度 (m/s²) / 加加速度 (m/s³)
+extern float   mp_creep;                    // 进航点前减到的最低速度 (占空比)
+extern float   mp_turn_slew;                // 换行驶方式时差速每周期最大变化
+} // namespace prm
+
+// ================== 注册表接口 ==================
+int   Param_count();
+int   Param_find(const char* name);          // -1: 没有这个参数
+int   Param_findHash(uint32_t name_hash);    // Flash 里按 param::hash(name, 0) 存，线性查找 (只在上电用)
+const param::Desc& Param_desc(int idx);
+float Param_get(int idx);
+bool  Param_set(int idx, float value, bool apply = true);  // 超出范围夹紧；idx 无效返回 false
+void  Param_resetDefaults();
+void  Param_applyAll();                      // 上电加载后把所有参数推给各模块
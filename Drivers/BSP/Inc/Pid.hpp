@@ -1,15 +1,143 @@
 #pragma once
 #include <algorithm> // 用于 std::clamp
+#include <limits>
+#include <type_traits>
 
-template <typename T>
-class PidController {
+/*
+ * PID 可选特性 (编译期策略)
+ * 用法: PidController<float, pid::DerivOnMeasurement, pid::DFilter>
+ * 每个策略只带自己需要的状态 (空基类优化，不选就不占空间)，
+ * compute 里用 if constexpr 展开，不选的特性连分支都不会生成。
+ */
+namespace pid {
+
+// 抗饱和：输出已限幅且误差继续往饱和方向推时，撤销本次积分 (条件积分)
+struct AntiWindupClamp {
+    template <typename T> struct State {};
+};
+
+// 抗饱和：反算法，I 项 += Kb * (限幅后输出 - 限幅前输出)
+// _integral 存的是误差累加和 (I 项 = Ki * _integral)，换算回来要除以 Ki；Ki 为 0 时没有 I 项，不用反算
+struct AntiWindupBackCalc {
+    template <typename T> struct State {
+        void setBackCalcGain(T kb) { _kb = kb; }
+    protected:
+        T _kb = T(1);
+    };
+};
+
+// 微分作用在测量值上：设定值跳变不会在输出上产生冲击
+struct DerivOnMeasurement {
+    template <typename T> struct State {};
+};
+
+// 微分项一阶低通：d = d + alpha * (d_raw - d)，alpha = 1 不滤波
+struct DFilter {
+    template <typename T> struct State {
+        void setDFilterAlpha(T alpha) { _d_alpha = alpha; }
+    protected:
+        T _d_alpha = T(1);
+        T _d_state = T(0);
+    };
+};
+
+// 输出变化率限制：每次 compute 输出最多变化 step
+struct OutputRateLimit {
+    template <typename T> struct State {
+        void setRateLimit(T step) { _rate_step = step; }
+    protected:
+        T _rate_step = std::numeric_limits<T>::max();
+        T _last_out = T(0);
+    };
+};
+
+// 微分由外部给出 (例如陀螺仪角速度)：compute(setpoint, measured, measured_rate)
+struct ExternalDerivative {
+    template <typename T> struct State {};
+};
+
+// 保存最近一次 compute 的 P / I / D 三项 (黑匣子记录用)
+struct RecordTerms {
+    template <typename T> struct State {
+        T pTerm() const { return _p_term; }
+        T iTerm() const { return _i_term; }
+        T dTerm() const { return _d_term; }
+    protected:
+        T _p_term = T(0);
+        T _i_term = T(0);
+        T _d_term = T(0);
+    };
+};
+
+} // namespace pid
+
+template <typename T, typename... Policies>
+class PidController : public Policies::template State<T>... {
 private:
+    template <typename P>
+    static constexpr bool has = (std::is_same_v<P, Policies> || ...);
+
+    static_assert(!(has<pid::AntiWindupClamp> && has<pid::AntiWindupBackCalc>),
+                  "choose one anti-windup policy");
+    static_assert(!(has<pid::DerivOnMeasurement> && has<pid::ExternalDerivative>),
+                  "choose one derivative source");
+
     T _kp, _ki, _kd;
     T _min_out, _max_out;
     T _integral;
-    T _last_error;
+    T _integral_limit;
+    T _last;          // 上次误差 (默认) 或上次测量值 (DerivOnMeasurement)
     bool _first_run;
 
+    // 公共部分：derivative 为 "误差每周期的变化量"
+    T update(T error, T derivative, bool hold_integral) {
+        // 1. 比例项
+        T p_out = _kp * error;
+
+        // 2. 积分项
+        if (!hold_integral) _integral += error;
+        _integral = std::clamp(_integral, -_integral_limit, _integral_limit);
+        T i_out = _ki * _integral;
+
+        // 3. 微分项
+        T d_out = _kd * derivative;
+        if constexpr (has<pid::DFilter>) {
+            this->_d_state += this->_d_alpha * (d_out - this->_d_state);
+            d_out = this->_d_state;
+        }
+
+        // 4. 总输出 + 限幅
+        T raw = p_out + i_out + d_out;
+        T output = std::clamp(raw, _min_out, _max_out);
+
+        // 5. 抗饱和
+        if constexpr (has<pid::AntiWindupClamp>) {
+            if (!hold_integral && output != raw && (raw - output) * error > T(0)) {
+                _integral -= error;
+            }
+        }
+        if constexpr (has<pid::AntiWindupBackCalc>) {
+            if (_ki != T(0)) {
+                _integral += this->_kb * (output - raw) / _ki;
+                _integral = std::clamp(_integral, -_integral_limit, _integral_limit);
+            }
+        }
+
+        if constexpr (has<pid::RecordTerms>) {
+            this->_p_term = p_out;
+            this->_i_term = i_out;
+            this->_d_term = d_out;
+        }
+
+        // 6. 变化率限制
+        if constexpr (has<pid::OutputRateLimit>) {
+            output = std::clamp(output, this->_last_out - this->_rate_step, this->_last_out + this->_rate_step);
+            this->_last_out = output;
+        }
+
+        return output;
+    }
+
 public:
     /**
      * @brief 构造函数
@@ -20,17 +148,21 @@ public:
      * @param max_out 输出上限
      */
     PidController(T kp, T ki, T kd, T min_out, T max_out)
-        : _kp(kp), _ki(ki), _kd(kd), 
-          _min_out(min_out), _max_out(max_out), 
-          _integral(0), _last_error(0), _first_run(true) {}
+        : _kp(kp), _ki(ki), _kd(kd),
+          _min_out(min_out), _max_out(max_out),
+          _integral(0), _integral_limit(std::numeric_limits<T>::max()),
+          _last(0), _first_run(true) {}
 
     /**
      * @brief 重置 PID 状态 (用于停车或重新开始时)
      */
     void reset() {
         _integral = 0;
-        _last_error = 0;
+        _last = 0;
         _first_run = true;
+        if constexpr (has<pid::DFilter>) this->_d_state = T(0);
+        if constexpr (has<pid::OutputRateLimit>) this->_last_out = T(0);
+        if constexpr (has<pid::RecordTerms>) this->_p_term = this->_i_term = this->_d_term = T(0);
     }
 
     /**
@@ -42,37 +174,43 @@ public:
         _kd = kd;
     }
 
+    /**
+     * @brief 积分累加量限幅 (|integral| <= limit)，默认不限
+     */
+    void setIntegralLimit(T limit) {
+        _integral_limit = limit;
+    }
+
     /**
      * @brief 计算 PID 输出
      * @param setpoint 目标值 (寻线时通常为 0)
      * @param measured 测量值 (当前的线路偏差)
+     * @param hold_integral 为 true 时本次不累加积分 (外部判定执行器已饱和时用)
      * @return T 控制量
      */
-    T compute(T setpoint, T measured) {
+    T compute(T setpoint, T measured, bool hold_integral = false) {
+        static_assert(!has<pid::ExternalDerivative>, "use compute(setpoint, measured, rate)");
         T error = setpoint - measured;
 
-        // 1. 比例项
-        T p_out = _kp * error;
-
-        // 2. 积分项 (带抗饱和)
-        _integral += error;
-        // 简单的积分限幅，防止积分飞升
-        // 更高级的做法是：如果输出饱和且误差同向，则停止积分
-        T i_out = _ki * _integral;
-
-        // 3. 微分项
-        T d_out = 0;
-        if (!_first_run) {
-            d_out = _kd * (error - _last_error);
+        T derivative = 0;
+        if constexpr (has<pid::DerivOnMeasurement>) {
+            if (!_first_run) derivative = _last - measured;
+            _last = measured;
         } else {
-            _first_run = false;
+            if (!_first_run) derivative = error - _last;
+            _last = error;
         }
-        _last_error = error;
+        _first_run = false;
 
-        // 4. 总输出
-        T output = p_out + i_out + d_out;
+        return update(error, derivative, hold_integral);
+    }
 
-        // 5. 输出限幅
-        return std::clamp(output, _min_out, _max_out);
+    /**
+     * @brief 计算 PID 输出 (ExternalDerivative)
+     * @param measured_rate 测量值每个控制周期的变化量 (例如 角速度 x 周期)
+     */
+    T compute(T setpoint, T measured, T measured_rate, bool hold_integral = false) {
+        static_assert(has<pid::ExternalDerivative>, "requires pid::ExternalDerivative");
+        return update(setpoint - measured, -measured_rate, hold_integral);
     }
-};
\ No newline at end of file
+};
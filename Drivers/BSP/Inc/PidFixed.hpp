@@ -0,0 +1,209 @@
+#pragma once
+
+#include "main.h"
+#include "Pid.hpp"
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+// ================== 配置参数 ==================
+#define PID_Q_GAIN_SHIFT  4   // 定点增益范围 ±2^SHIFT (4 -> ±16)，精度随之降低 SHIFT 位
+#define PID_Q31_I_SHIFT   8   // Q31 的 I 项乘法前积分量先右移的位数 (Q27 增益 x 累加量不溢出 int64)
+#define PID_Q31_I_MAX     255 // Q31 积分限幅上限 (误差单位)：累加量 < 2^39，右移 PID_Q31_I_SHIFT 后在 int32 范围内
+
+/*
+ * Q 格式定点数：值 = raw / 2^FRAC，范围 [-1, 1)
+ * 只做一层薄包装，让 PidController<Q15> / <Q31> 能和 float 版本并存。
+ */
+template <typename Raw, int Frac>
+struct QNum {
+    using raw_type = Raw;
+    static constexpr int FRAC = Frac;
+
+    Raw raw;
+
+    static constexpr QNum fromFloat(float f) {
+        constexpr float scale = (float)(1LL << Frac);
+        float v = f * scale;
+        if (v >= scale) return {static_cast<Raw>((1LL << Frac) - 1)};
+        if (v < -scale) return {static_cast<Raw>(-(1LL << Frac))};
+        return {static_cast<Raw>(v)};
+    }
+    constexpr float toFloat() const { return (float)raw / (float)(1LL << Frac); }
+};
+
+using Q15 = QNum<int16_t, 15>;
+using Q31 = QNum<int32_t, 31>;
+
+// ====== DSP 扩展指令：目标板用 CMSIS 内建函数，其它平台退回等价的 C 实现 ======
+namespace qmath {
+
+inline int32_t ssat16(int32_t x) {
+#if defined(__ARM_FEATURE_DSP)
+    return __SSAT(x, 16);
+#else
+    return x > INT16_MAX ? INT16_MAX : (x < INT16_MIN ? INT16_MIN : x);
+#endif
+}
+
+inline int32_t qadd(int32_t a, int32_t b) {
+#if defined(__ARM_FEATURE_DSP)
+    return __QADD(a, b);
+#else
+    int64_t r = (int64_t)a + b;
+    return r > INT32_MAX ? INT32_MAX : (r < INT32_MIN ? INT32_MIN : (int32_t)r);
+#endif
+}
+
+inline int32_t qsub(int32_t a, int32_t b) {
+#if defined(__ARM_FEATURE_DSP)
+    return __QSUB(a, b);
+#else
+    int64_t r = (int64_t)a - b;
+    return r > INT32_MAX ? INT32_MAX : (r < INT32_MIN ? INT32_MIN : (int32_t)r);
+#endif
+}
+
+// 两组 16bit 乘积同时累加：acc + x.lo * y.lo + x.hi * y.hi
+inline int32_t smlad(uint32_t x, uint32_t y, int32_t acc) {
+#if defined(__ARM_FEATURE_DSP)
+    return (int32_t)__SMLAD(x, y, (uint32_t)acc);
+#else
+    return acc + (int32_t)(int16_t)x * (int16_t)y + (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16);
+#endif
+}
+
+inline uint32_t pack16(int32_t lo, int32_t hi) {
+    return (uint32_t)(uint16_t)lo | ((uint32_t)(uint16_t)hi << 16);
+}
+
+inline int32_t sat32(int64_t x) {
+    return x > INT32_MAX ? INT32_MAX : (x < INT32_MIN ? INT32_MIN : (int32_t)x);
+}
+
+} // namespace qmath
+
+/*
+ * 定点 PID 的公共状态：增益按 float 传入，内部存成 Q(FRAC - GAIN_SHIFT)；
+ * 积分累加量和误差同为 Q(FRAC)，Q15 用 int32 饱和累加 (±65536)，Q31 用 int64 (±PID_Q31_I_MAX)，
+ * 这样 Ki 很小时累加量可以远大于 1，I 项和 float 版本一样能积满。
+ * setIntegralLimit 限幅按 float 传入 (单位同误差，和 PidController<float> 一致)，超出累加量范围时取上限。
+ */
+template <typename Q>
+class FixedPidBase {
+public:
+    FixedPidBase(float kp, float ki, float kd, Q min_out, Q max_out)
+        : _min_out(min_out.raw), _max_out(max_out.raw) {
+        setTunings(kp, ki, kd);
+    }
+
+    void reset() {
+        _integral = 0;
+        _last_error = 0;
+        _first_run = true;
+    }
+
+    void setTunings(float kp, float ki, float kd) {
+        _kp = gain(kp);
+        _ki = gain(ki);
+        _kd = gain(kd);
+    }
+
+    void setIntegralLimit(float limit) {
+        float v = std::fabs(limit) * (float)(1LL << Q::FRAC);
+        _integral_limit = (v >= (float)ACC_MAX) ? ACC_MAX : (Acc)v;
+    }
+
+protected:
+    static constexpr int GAIN_FRAC = Q::FRAC - PID_Q_GAIN_SHIFT;
+    static_assert(GAIN_FRAC > 0, "PID_Q_GAIN_SHIFT too large");
+
+    using Acc = std::conditional_t<(Q::FRAC > 15), int64_t, int32_t>;
+    static constexpr Acc ACC_MAX = (Q::FRAC > 15) ? (Acc)((int64_t)PID_Q31_I_MAX << Q::FRAC) : (Acc)INT32_MAX;
+
+    static int32_t gain(float k) {
+        float v = k * (float)(1LL << GAIN_FRAC);
+        constexpr float lim = (float)(1LL << Q::FRAC);
+        if (v >= lim) v = lim - 1.0f;
+        if (v < -lim) v = -lim;
+        return (int32_t)v;
+    }
+
+    Acc integrate(int32_t error, bool hold) {
+        if constexpr (sizeof(Acc) == 8) {
+            if (!hold) _integral += error;   // 限幅远小于 int64 范围，先加后夹不会溢出
+        } else {
+            if (!hold) _integral = qmath::qadd(_integral, error);
+        }
+        if (_integral >  _integral_limit) _integral =  _integral_limit;
+        if (_integral < -_integral_limit) _integral = -_integral_limit;
+        return _integral;
+    }
+
+    int32_t derivative(int32_t error) {
+        int32_t de = 0;
+        if (!_first_run) {
+            de = qmath::qsub(error, _last_error);
+        } else {
+            _first_run = false;
+        }
+        _last_error = error;
+        return de;
+    }
+
+    int32_t limit(int32_t out) const {
+        return out < _min_out ? _min_out : (out > _max_out ? _max_out : out);
+    }
+
+    int32_t _kp = 0, _ki = 0, _kd = 0;
+    int32_t _min_out, _max_out;
+    Acc _integral = 0;
+    Acc _integral_limit = ACC_MAX;
+    int32_t _last_error = 0;
+    bool _first_run = true;
+};
+
+/*
+ * Q15：P、D 两项打包成一条 SMLAD (两路 16x16 乘加一条指令)，
+ * I 项 32x16 乘积饱和加上去，最后 SSAT 回 16bit。
+ */
+template <>
+class PidController<Q15> : public FixedPidBase<Q15> {
+public:
+    using FixedPidBase<Q15>::FixedPidBase;
+
+    Q15 compute(Q15 setpoint, Q15 measured, bool hold_integral = false) {
+        int32_t error = qmath::ssat16((int32_t)setpoint.raw - measured.raw);
+        int32_t de = qmath::ssat16(derivative(error));
+        int32_t integral = integrate(error, hold_integral);
+
+        // Q15 x Q(15-SHIFT) = Q(30-SHIFT)
+        int32_t acc = qmath::smlad(qmath::pack16(error, de), qmath::pack16(_kp, _kd), 0);
+        acc = qmath::qadd(acc, qmath::sat32((int64_t)_ki * integral));
+
+        int32_t out = qmath::ssat16(acc >> GAIN_FRAC);
+        return {static_cast<int16_t>(limit(out))};
+    }
+};
+
+/*
+ * Q31：32x32 乘积用 64bit 累加 (SMLAL)，每项先移回 Q31 再相加，三项同号叠加也不会溢出 int64。
+ * 积分累加量是 int64，乘 Ki 前先右移 PID_Q31_I_SHIFT 位 (丢掉的是 2^-23 以下的误差和)。
+ */
+template <>
+class PidController<Q31> : public FixedPidBase<Q31> {
+public:
+    using FixedPidBase<Q31>::FixedPidBase;
+
+    Q31 compute(Q31 setpoint, Q31 measured, bool hold_integral = false) {
+        int32_t error = qmath::qsub(setpoint.raw, measured.raw);
+        int32_t de = derivative(error);
+        int32_t integral = (int32_t)(integrate(error, hold_integral) >> PID_Q31_I_SHIFT);
+
+        int64_t sum = (((int64_t)_kp * error) >> GAIN_FRAC)
+                    + (((int64_t)_ki * integral) >> (GAIN_FRAC - PID_Q31_I_SHIFT))
+                    + (((int64_t)_kd * de) >> GAIN_FRAC);
+
+        return {limit(qmath::sat32(sum))};
+    }
+};
@@ -7,6 +7,7 @@
 // 定义 ID: 目前寻线只需要一个转向 PID
 #define PID_ID_TURN  0
 #define PID_ID_FORWARD 1     // 预留前进 PID
+#define PID_ID_WHEEL   2     // 轮速内环 PI (左右轮共用)
 #define MAX_PID_NUM  4       // 预留 4 组
 #define PID_MAGIC    0x5AA5  // 校验魔数
 
@@ -35,7 +36,11 @@ public:
     // 上电初始化：读 Flash 到 RAM
     bool load() {
         if (!_flash.init()) return false;
+        return loadCache();
+    }
 
+    // 芯片已探测过 (开机调度器里 probe() 通过) 时直接读参数
+    bool loadCache() {
         _flash.readData(_addr, (uint8_t*)&_cache, sizeof(_cache));
 
         if (_cache.magic == PID_MAGIC) {
@@ -44,6 +49,7 @@ public:
             // Flash 为空，加载默认值
             _cache.magic = PID_MAGIC;
             _cache.pids[PID_ID_TURN] = {0.1f, 0.0f, 0.2f}; // 默认参数
+            _cache.pids[PID_ID_WHEEL] = {0.5f, 0.005f, 0.0f};
             return false;
         }
     }
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * 路线表
+ * 一道题 = 一串路段；每段规定怎么走 (航向保持直线 / 循线 / 停车)、
+ * 进入时做什么 (提示、锁航向、清循线 PID) 和什么时候切到下一段
+ * (传感器有线/无线边沿、走过的距离、转过的角度、时间)。
+ * LineFollower 只解释当前段，新题目只需要加一张表 (Routes.cpp) 或串口 ROUTESET 下发，不改控制代码。
+ */
+#define ROUTE_QUESTIONS  4    // UI 上的 Q1..Q4
+#define ROUTE_MAX_SEG    16
+
+namespace route {
+
+enum class Drive : uint8_t {
+    YawHold = 0,     // 航向保持走直线，速度 prm::speed_straight
+    LineFollow,      // 循线，速度 prm::speed_arc
+    Stop,
+};
+
+enum class Trigger : uint8_t {
+    End = 0,         // 不切换 (最后一段)
+    LineRise,        // 无线 -> 有线
+    LineFall,        // 有线 -> 无线
+    Distance,        // 本段走过 arg 米
+    Heading,         // 本段航向变化 |Δyaw| >= arg 度
+    Time,            // 本段持续 arg 毫秒
+};
+
+enum : uint8_t {
+    Prompt       = 0x01,   // 声光提示一次
+    LockYaw      = 0x02,   // 以当前航向为直线参考
+    ResetTurnPid = 0x04,   // 清循线 PID 积分/微分历史
+};
+
+} // namespace route
+
+// 8 字节，Flash 里按原样存
+struct RouteSegment {
+    route::Drive   drive;
+    route::Trigger exit;
+    uint8_t        actions;   // 进入本段时执行
+    uint8_t        reserved;
+    float          arg;       // 退出条件参数
+};
+static_assert(sizeof(RouteSegment) == 8, "RouteSegment must stay 8 bytes");
+
+struct Route {
+    const RouteSegment* seg;
+    uint8_t count;            // 0: 本题不开车
+};
+
+// 编译期检查：只有最后一段可以是 End，且最后一段必须是 End
+template <size_t N>
+constexpr bool Route_valid(const RouteSegment (&r)[N]) {
+    if (N == 0 || N > ROUTE_MAX_SEG) return false;
+    for (size_t i = 0; i + 1 < N; i++) {
+        if (r[i].exit == route::Trigger::End) return false;
+    }
+    return r[N - 1].exit == route::Trigger::End;
+}
+
+// Flash 里的整套路线 (只存串口下发过的题，count 为 0 的题用内置表)
+struct RouteFlash {
+    uint32_t magic;
+    uint8_t  count[ROUTE_QUESTIONS];
+    uint32_t sum;             // seg 逐字节累加和
+    RouteSegment seg[ROUTE_QUESTIONS][ROUTE_MAX_SEG];
+};
+
+Route Route_get(uint8_t q);                                   // q: 1..ROUTE_QUESTIONS，其它返回空路线
+bool  Route_set(uint8_t q, const RouteSegment* seg, uint8_t n);  // n == 0 恢复内置表
+bool  Route_isCustom(uint8_t q);
+int   Route_parse(const char* spec, RouteSegment* out, int max);  // 返回段数，格式错 -1
+int   Route_format(uint8_t q, char* buf, size_t n);
+void  Route_import(const RouteFlash& f);
+void  Route_export(RouteFlash& f);
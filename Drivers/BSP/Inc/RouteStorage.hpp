@@ -0,0 +1,50 @@
+#pragma once
+#include "W25Q64.hpp"
+#include "Route.hpp"
+
+#include "SEGGER_RTT.h"
+
+// 串口下发的路线放在参数表 (0x7FC000) 下面一个扇区
+#define ROUTE_FLASH_ADDR  0x7FB000
+#define ROUTE_MAGIC       0x31455452U // "RTE1"
+
+static_assert(sizeof(RouteFlash) <= 4096, "routes must fit in one sector");
+
+class RouteStorage {
+private:
+    W25Q64& _flash;
+    uint32_t _addr;
+
+    static uint32_t checksum(const RouteFlash& f) {
+        uint32_t sum = 0;
+        const uint8_t* p = (const uint8_t*)f.seg;
+        for (uint32_t i = 0; i < sizeof(f.seg); i++) sum += p[i];
+        return sum;
+    }
+
+public:
+    RouteStorage(W25Q64& f, uint32_t addr = ROUTE_FLASH_ADDR) : _flash(f), _addr(addr) {}
+
+    // 上电：有效就覆盖对应题的内置路线
+    bool load() {
+        static RouteFlash f;
+        _flash.readData(_addr, (uint8_t*)&f, sizeof(f));
+        if (f.magic != ROUTE_MAGIC || f.sum != checksum(f)) return false;
+        Route_import(f);
+        return true;
+    }
+
+    void save() {
+        static RouteFlash f;
+        Route_export(f);
+        f.magic = ROUTE_MAGIC;
+        f.sum = checksum(f);
+
+        _flash.eraseSector(_addr);
+        const uint8_t* p = (const uint8_t*)&f;
+        for (uint32_t off = 0; off < sizeof(f); off += 256) {
+            uint32_t n = sizeof(f) - off;
+            _flash.writePage(_addr + off, (uint8_t*)p + off, n > 256 ? 256 : n);
+        }
+    }
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "main.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * 灰度传感器阵列描述 (编译期)
+ * Sensor<引脚, 权重>: 一路传感器；SensorArray<端口基址, Sensor...>: 从左到右排列的一整排。
+ * 位置误差 = 压线传感器权重的平均值，对所有组合在编译期预先算好。
+ * 查找表直接以端口原始值里 "最低到最高传感器引脚" 这一段 bit 为下标 (不在阵列里的 bit 不影响结果)，
+ * 运行时一次移位 + 一次与 + 一次查表；引脚跨度最多 8 bit (表最多 256 项)。
+ * 权重在参数表里可调 (line.w0..)，改动时 setWeights() 在主循环重算运行时表 lut。
+ * 换线束 / 改路数只需要换一个 SensorArray 类型。
+ */
+template <uint16_t Pin, int Weight>
+struct Sensor {
+    static constexpr uint16_t pin = Pin;
+    static constexpr int weight = Weight;
+};
+
+template <uint32_t PortBase, typename... Sensors>
+struct SensorArray {
+    static constexpr size_t count = sizeof...(Sensors);
+    static_assert(count > 0 && count <= 8, "1..8 sensors supported");
+
+    static constexpr uint16_t pins[count]   = {Sensors::pin...};
+    static constexpr int      weights[count] = {Sensors::weight...};
+    static constexpr uint16_t mask = (Sensors::pin | ...);
+
+    static constexpr uint32_t lowBit(uint16_t m) {
+        uint32_t b = 0;
+        while (!(m & (1U << b))) b++;
+        return b;
+    }
+    static constexpr uint32_t highBit(uint16_t m) {
+        uint32_t b = 15;
+        while (!(m & (1U << b))) b--;
+        return b;
+    }
+
+    // 查找表下标 = (raw >> shift) & (size - 1)
+    static constexpr uint32_t shift = lowBit(mask);
+    static constexpr uint32_t span  = highBit(mask) - shift + 1U;
+    static_assert(span <= 8, "sensor pins must lie within 8 adjacent bits of the port");
+    static constexpr uint32_t size  = 1U << span;
+
+    static GPIO_TypeDef* port() { return reinterpret_cast<GPIO_TypeDef*>(PortBase); }
+
+    static constexpr uint32_t index(uint16_t raw) { return (raw >> shift) & (size - 1U); }
+
+    static constexpr std::array<float, size> makeErrorLut(const int (&w)[count]) {
+        std::array<float, size> lut{};
+        for (uint32_t idx = 0; idx < size; idx++) {
+            int sum = 0;
+            int n = 0;
+            for (size_t k = 0; k < count; k++) {
+                if ((idx << shift) & pins[k]) { sum += w[k]; n++; }
+            }
+            // 没有传感器压线的下标 positionError 不会用到，留 0
+            if (n) lut[idx] = static_cast<float>(sum) / static_cast<float>(n);
+        }
+        return lut;
+    }
+
+    static constexpr std::array<float, size> errorLut = makeErrorLut(weights);
+
+    // 运行时查找表，上电等于编译期的 errorLut
+    static inline std::array<float, size> lut = errorLut;
+
+    // 换权重：整表重算一遍；逐项覆盖，控制中断最多读到一个周期新旧混合的表
+    static void setWeights(const int (&w)[count]) {
+        const std::array<float, size> next = makeErrorLut(w);
+        for (uint32_t idx = 0; idx < size; idx++) lut[idx] = next[idx];
+    }
+
+    // 位置误差；没有传感器压线时返回 false
+    static bool positionError(uint16_t raw, float& out) {
+        if (!(raw & mask)) return false;
+        out = lut[index(raw)];
+        return true;
+    }
+};
+
+// ================== 本车线束 ==================
+// 从左到右: PA15, PA12, PA11, PA10, PA8
+// 注意：权重为非对称配置 (-5, 2, 0, 2, 5)，根据实际硬件布局调整
+using LineSensors = SensorArray<GPIOA_BASE,
+                                Sensor<GPIO_PIN_15, -5>,
+                                Sensor<GPIO_PIN_12,  2>,
+                                Sensor<GPIO_PIN_11,  0>,
+                                Sensor<GPIO_PIN_10,  2>,
+                                Sensor<GPIO_PIN_8,   5>>;
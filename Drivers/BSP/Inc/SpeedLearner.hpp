@@ -0,0 +1,49 @@
+#pragma once
+
+#include "LapTimer.hpp"
+#include "Route.hpp"
+#include <cstdint>
+
+/*
+ * 分段速度迭代学习 (不依赖 HAL，主机仿真 tools/ilc_sim 与固件共用)
+ * 每跑完一圈，按该圈的分段成绩逐段修正速度：
+ *   丢线 / 误差峰值超限 / 外环饱和时间占比超限 -> 乘 backoff 退回
+ *   误差峰值不到限值一半且没饱和 (且这一圈没作废)   -> 加 step
+ * 速度 0 表示该段还没学过，用行驶方式对应的默认速度起步。
+ */
+struct LearnConfig {
+    float err_line;   // 循线段误差峰值上限 (传感器权重单位)
+    float err_yaw;    // 航向保持段误差峰值上限 (°)
+    float sat_frac;   // 饱和时间 / 段用时 上限
+    float step;       // 每圈加速量 (占空比)
+    float backoff;    // 超限时速度乘的系数
+    float vmin, vmax;
+};
+
+// 返回改动的段数
+inline int SpeedLearner_update(float* speeds, const SegmentSplit* s, uint8_t n, bool aborted,
+                               const LearnConfig& c, float def_straight, float def_arc) {
+    int changed = 0;
+    for (uint8_t i = 0; i < n && i < ROUTE_MAX_SEG; i++) {
+        route::Drive drive = static_cast<route::Drive>(s[i].drive);
+        if (drive == route::Drive::Stop) continue;
+
+        float def = drive == route::Drive::LineFollow ? def_arc : def_straight;
+        float v = speeds[i] > 0.0f ? speeds[i] : def;
+        float limit = drive == route::Drive::LineFollow ? c.err_line : c.err_yaw;
+        bool sat = s[i].ms > 0 && (float)s[i].sat_ms > c.sat_frac * (float)s[i].ms;
+
+        float next = v;
+        if (s[i].lost || s[i].peak_err > limit || sat) {
+            next = v * c.backoff;
+        } else if (!aborted && s[i].peak_err < 0.5f * limit) {
+            next = v + c.step;
+        }
+        if (next < c.vmin) next = c.vmin;
+        if (next > c.vmax) next = c.vmax;
+
+        if (next != speeds[i]) changed++;
+        speeds[i] = next;
+    }
+    return changed;
+}
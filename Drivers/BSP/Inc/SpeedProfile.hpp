@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Route.hpp"
+#include <cstdint>
+
+/*
+ * 学到的分段速度 (每题每段一个占空比，0 = 没学过)
+ * 控制中断按 题号 + 段号 直接查表；学习和落盘在主循环 (SpeedProfile.cpp)。
+ */
+extern float g_speed_profile[ROUTE_QUESTIONS][ROUTE_MAX_SEG];
+
+inline float SpeedProfile_speed(uint8_t q, uint8_t seg, float def) {
+    if (q < 1 || q > ROUTE_QUESTIONS || seg >= ROUTE_MAX_SEG) return def;
+    float v = g_speed_profile[q - 1][seg];
+    return v > 0.0f ? v : def;
+}
+
+void SpeedProfile_Load(void);          // 上电 (W25Q64 已探测)
+void SpeedProfile_Poll(void);          // 主循环：有新一圈成绩且开了学习就修正速度，停车后落盘
+void SpeedProfile_Clear(uint8_t q);    // q = 0 清全部；改路线时必须清该题
+void SpeedProfile_Report(void);        // 串口 "ILC"
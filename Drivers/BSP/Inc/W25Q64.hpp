@@ -72,6 +72,19 @@ public:
     W25Q64(SPI_HandleTypeDef* hspi, GPIO_TypeDef* cs_port, uint16_t cs_pin)
         : _hspi(hspi), _cs_port(cs_port), _cs_pin(cs_pin) {}
 
+    // 读一次 JEDEC ID，不等待 (开机调度器分步调用；上电后需先留 20ms)
+    bool probe() {
+        csLow();
+        spiSwap(W25Q_CMD_JEDEC_ID);
+        uint8_t mid = spiSwap(0xFF);
+        uint8_t mtype = spiSwap(0xFF);
+        uint8_t mcap = spiSwap(0xFF);
+        csHigh();
+
+        RTT_Log("[W25Q64] JEDEC ID: MID=0x%02X, Type=0x%02X, Cap=0x%02X\r\n", mid, mtype, mcap);
+        return mid == 0xEF;
+    }
+
     // 初始化 (简单的 ID 读取测试)
     bool init() {
         csHigh();
@@ -79,17 +92,7 @@ public:
 
         // 重试3次
         for(int retry = 0; retry < 3; retry++) {
-            csLow();
-            spiSwap(W25Q_CMD_JEDEC_ID);
-            uint8_t mid = spiSwap(0xFF);
-            uint8_t mtype = spiSwap(0xFF);
-            uint8_t mcap = spiSwap(0xFF);
-            csHigh();
-
-            RTT_Log("[W25Q64] Init Attempt %d: MID=0x%02X, Type=0x%02X, Cap=0x%02X\r\n",
-                    retry+1, mid, mtype, mcap);
-
-            if (mid == 0xEF) {
+            if (probe()) {
                 return true;
             }
 
@@ -100,8 +103,17 @@ public:
         return false;
     }
 
-    // 擦除一个 4KB 扇区
-    void eraseSector(uint32_t address) {
+    // 芯片是否还在擦除 / 编程 (不等待)
+    bool busy() {
+        csLow();
+        spiSwap(W25Q_CMD_READ_STATUS_REG1);
+        uint8_t status = spiSwap(0xFF);
+        csHigh();
+        return (status & 0x01) == 0x01;
+    }
+
+    // 只发出扇区擦除命令就返回，调用方用 busy() 轮询 (后台写日志用)
+    void eraseSectorStart(uint32_t address) {
         waitForReady();
         writeEnable();
 
@@ -111,12 +123,10 @@ public:
         spiSwap((address >> 8) & 0xFF);
         spiSwap(address & 0xFF);
         csHigh();
-
-        waitForReady(); // 擦除需要时间 (典型值 45ms)
     }
 
-    // 写入数据 (页编程)
-    void writePage(uint32_t address, uint8_t* data, uint16_t size) {
+    // 只把一页数据送进芯片就返回，编程在芯片内部完成 (典型 0.7ms)
+    void writePageStart(uint32_t address, const uint8_t* data, uint16_t size) {
         waitForReady();
         writeEnable();
 
@@ -130,7 +140,17 @@ public:
             spiSwap(data[i]);
         }
         csHigh();
+    }
 
+    // 擦除一个 4KB 扇区
+    void eraseSector(uint32_t address) {
+        eraseSectorStart(address);
+        waitForReady(); // 擦除需要时间 (典型值 45ms)
+    }
+
+    // 写入数据 (页编程)
+    void writePage(uint32_t address, uint8_t* data, uint16_t size) {
+        writePageStart(address, data, size);
         waitForReady();
     }
 
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "main.h"
+#include "Pid.hpp"
+#include "EncoderVelocity.hpp"
+#include <algorithm>
+#include <cstdint>
+
+// ================== 配置参数 ==================
+#define WSL_VMAX_MPS       1.20f   // 满占空比对应的空载轮速，前馈斜率 = 1 / VMAX
+#define WSL_FF_STATIC      0.03f   // 静摩擦补偿占空比 (目标非零时按方向叠加)
+#define WSL_I_LIMIT        50.0f   // 积分累加限幅 (误差 m/s x 周期数)
+
+// 单个轮子：速度 PI + 前馈，输出占空比 [-1, 1]
+struct WheelChannel {
+    EncoderVelocity vel;
+    float    speed = 0.0f;           // 测得轮速 m/s
+    float    duty = 0.0f;            // 上周期输出占空比
+    volatile float target = 0.0f;    // 目标轮速 m/s (外环写)
+    PidController<float> pid;
+
+    WheelChannel(TIM_HandleTypeDef* e, int8_t d, const EncoderPhaseA& a)
+        : vel(e, d, a), pid(0.0f, 0.0f, 0.0f, -1.0f, 1.0f) {
+        pid.setIntegralLimit(WSL_I_LIMIT);
+    }
+};
+
+/*
+ * WheelSpeedLoop
+ * 1kHz 轮速内环：外环 (TIM7, 50Hz 循线/航向) 只给左右轮目标速度，
+ * 内环按编码器实测速度闭环修正占空比。
+ *   duty = target / VMAX + sign(target) * FF_STATIC + PI(target - speed)
+ * 前馈承担大部分输出，PI 只补负载和电池电压变化；PI 增益为 0 时退化成原来的开环占空比。
+ * 饱和处理：积分累加量限幅，且输出已经顶到 ±1 并与误差同向时暂停积分。
+ * 测速用 EncoderVelocity (A 相边沿时间戳 M/T 法)，编码器由 Odometry::begin() 启动。
+ */
+class WheelSpeedLoop {
+public:
+    WheelSpeedLoop(TIM_HandleTypeDef* enc_l, TIM_HandleTypeDef* enc_r)
+        : _l(enc_l, ODOM_LEFT_DIR, ENC_LEFT_A), _r(enc_r, ODOM_RIGHT_DIR, ENC_RIGHT_A) {}
+
+    // 编码器启动之后调用
+    void begin() {
+        _l.vel.begin();
+        _r.vel.begin();
+        _l.speed = _r.speed = 0.0f;
+        _l.duty = _r.duty = 0.0f;
+        _active = false;
+        _reset_req = true;
+    }
+
+    // 外环调用：目标轮速 (m/s)
+    void setTarget(float v_l, float v_r) {
+        _l.target = v_l;
+        _r.target = v_r;
+        _active = true;
+    }
+
+    // 外环调用：停车并在下一个内环周期清积分
+    void stop() {
+        _active = false;
+        _l.target = 0.0f;
+        _r.target = 0.0f;
+        _reset_req = true;
+    }
+
+    void setTunings(float kp, float ki, float kd) {
+        _l.pid.setTunings(kp, ki, kd);
+        _r.pid.setTunings(kp, ki, kd);
+    }
+
+    // EXTI 回调：编码器 A 相边沿，返回 false 表示不是编码器引脚
+    bool onEncoderEdge(uint16_t pin) {
+        uint32_t cyc = DWT->CYCCNT;
+        if (pin == _l.vel.pin()) { _l.vel.onEdge(cyc); return true; }
+        if (pin == _r.vel.pin()) { _r.vel.onEdge(cyc); return true; }
+        return false;
+    }
+
+    // 内环 (TIM17) 调用，输出左右占空比
+    void update(float& duty_l, float& duty_r) {
+        uint32_t now = DWT->CYCCNT;
+        _l.speed = _l.vel.sample(now);
+        _r.speed = _r.vel.sample(now);
+
+        // 复位请求在内环上下文执行，避免和 compute 互相打断
+        if (_reset_req) {
+            _reset_req = false;
+            _l.pid.reset();
+            _r.pid.reset();
+            _l.duty = 0.0f;
+            _r.duty = 0.0f;
+        }
+
+        if (!_active) {
+            duty_l = 0.0f;
+            duty_r = 0.0f;
+            return;
+        }
+        duty_l = control(_l);
+        duty_r = control(_r);
+    }
+
+    float speedLeft() const { return _l.speed; }
+    float speedRight() const { return _r.speed; }
+    bool active() const { return _active; }
+
+private:
+    static float control(WheelChannel& w) {
+        float target = w.target;
+        float ff = target / WSL_VMAX_MPS;
+        if (target > 0.0f) ff += WSL_FF_STATIC;
+        else if (target < 0.0f) ff -= WSL_FF_STATIC;
+
+        // 上周期输出已顶到限幅且误差仍往同方向推：积分只会越积越多，本周期暂停
+        float err = target - w.speed;
+        bool hold = (w.duty >= 1.0f && err > 0.0f) || (w.duty <= -1.0f && err < 0.0f);
+
+        w.duty = std::clamp(ff + w.pid.compute(target, w.speed, hold), -1.0f, 1.0f);
+        return w.duty;
+    }
+
+    WheelChannel _l;
+    WheelChannel _r;
+    volatile bool _active = false;
+    volatile bool _reset_req = true;
+};
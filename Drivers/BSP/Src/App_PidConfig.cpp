@@ -1,10 +1,24 @@
 #include "App_PidConfig.h"
 #include "PidStorage.hpp"
+#include "ParamStorage.hpp"
+#include "RouteStorage.hpp"
+#include "GyroBiasStorage.hpp"
+#include "CrashStorage.hpp"
 #include "W25Q64.hpp"
 #include "LineFollower_Interface.h"
+#include "IMU.h"
+#include "BlackBox_Interface.h"
+#include "Boot.h"
+#include "MemWatch.h"
+#include "LapTimer_Interface.h"
+#include "SpeedProfile.hpp"
+#include "ui.h"
 #include "main.h"
 #include "spi.h"
+#include <cstdarg>
+#include <cmath>
 #include <cstdio>  // for sscanf, RTT_Log
+#include <cstdlib>
 #include <cstring> // for strncmp
 
 #include "SEGGER_RTT.h"
@@ -21,30 +35,94 @@ UartRingBuffer serialRx(&huart3, dma_rx_buffer, SERIAL_BUF_SIZE);
 
 // === 硬件对象实例化 ===
 W25Q64 w25q(&hspi2, SPI2_CS_GPIO_Port, SPI2_CS_Pin);
-PidStorage pidStore(w25q);
+PidStorage pidStore(w25q);     // 旧 PID 扇区，只在参数表为空时迁移一次
+ParamStorage paramStore(w25q);
+RouteStorage routeStore(w25q);
+GyroBiasStorage biasStore(w25q);
+CrashStorage crashStore(w25q);
+
+// 旧 PID 扇区的三组增益写进参数表 (PidStorage 为空时也给出和以前一样的默认值)
+static void App_Param_MigratePid() {
+    static const char* const names[3][3] = {
+        {"lpid.p", "lpid.i", "lpid.d"},
+        {"fpid.p", "fpid.i", "fpid.d"},
+        {"wpid.p", "wpid.i", "wpid.d"},
+    };
+    for (uint8_t id = 0; id < 3; id++) {
+        PidConfig c = pidStore.get(id);
+        Param_set(Param_find(names[id][0]), c.kp, false);
+        Param_set(Param_find(names[id][1]), c.ki, false);
+        Param_set(Param_find(names[id][2]), c.kd, false);
+    }
+}
+
+// Flash 探测之后的部分：读参数表 / 零偏表 / 崩溃现场并注入控制器
+static void App_Pid_Load(bool flash_ok) {
+    // 1. 加载参数 (变量在静态初始化时已是默认值)
+    bool valid = flash_ok && paramStore.load();
 
-void App_Pid_Init(void) {
-    // 1. 初始化 Flash 并加载参数
-    bool valid = pidStore.load();
-    
     if (valid) {
-        RTT_Log("[System] PID loaded from Flash.\r\n");
+        RTT_Log("[System] Params loaded from Flash.\r\n");
+    } else if (flash_ok && pidStore.loadCache()) {
+        // 老固件留下的 PID 扇区：迁移过来并写成新格式
+        App_Param_MigratePid();
+        paramStore.save();
+        RTT_Log("[System] PID migrated from legacy sector.\r\n");
     } else {
         RTT_Log("[System] Flash empty. Using defaults & Saving...\r\n");
-        pidStore.save(); // 保存默认值
+        if (flash_ok) paramStore.save(); // 保存默认值
     }
 
-    // === 加载并注入 Turn PID (ID 0) ===
-    PidConfig cfgTurn = pidStore.get(PID_ID_TURN);
-    LineFollower_SetPID(PID_ID_TURN, cfgTurn.kp, cfgTurn.ki, cfgTurn.kd);
+    // 串口下发过的路线覆盖内置表
+    if (flash_ok && routeStore.load()) {
+        RTT_Log("[System] Routes loaded from Flash.\r\n");
+    }
+    if (flash_ok) SpeedProfile_Load();
 
-    // === 【新增】加载并注入 Forward PID (ID 1) ===
-    PidConfig cfgFwd = pidStore.get(PID_ID_FORWARD);
-    LineFollower_SetPID(PID_ID_FORWARD, cfgFwd.kp, cfgFwd.ki, cfgFwd.kd);
-    
-    RTT_Log("[System] Applied PID: Turn P=%f I=%f D=%f | Forward P=%f I=%f D=%f\r\n",
-            cfgTurn.kp, cfgTurn.ki, cfgTurn.kd,
-            cfgFwd.kp, cfgFwd.ki, cfgFwd.kd);
+    // 陀螺零偏-温度表 (空表时 IMU 退回静止标定的零偏)
+    if (biasStore.load()) {
+        RTT_Log("[System] Gyro bias table loaded, %d bins.\r\n", GyroBias_learnedBins());
+    }
+
+    // 上次运行崩溃/Error_Handler 留下的现场落盘 (串口 "CRASH" 导出)
+    crashStore.persist();
+    CrashLog_Trace(TRACE_BOOT, (uint16_t)(RCC->RSR >> 16));
+    __HAL_RCC_CLEAR_RESET_FLAGS();
+
+    // === 所有参数推给控制器 / 传感器查找表 / 姿态滤波器 ===
+    Param_applyAll();
+
+    RTT_Log("[System] Applied PID: Turn P=%f I=%f D=%f | Forward P=%f I=%f D=%f | Wheel P=%f I=%f D=%f\r\n",
+            prm::lpid_p, prm::lpid_i, prm::lpid_d,
+            prm::fpid_p, prm::fpid_i, prm::fpid_d,
+            prm::wpid_p, prm::wpid_i, prm::wpid_d);
+}
+
+void App_Pid_Init(void) {
+    App_Pid_Load(w25q.init());
+}
+
+// 与 App_Pid_Init 相同，但 W25Q64 上电等待和 ID 重试交给开机调度器，不阻塞
+int App_Pid_InitStep(void) {
+    static uint8_t stage = 0;
+    static uint8_t tries = 0;
+
+    switch (stage) {
+        case 0: {
+            // W25Q64 上电后 20ms 才能读 ID，从复位算起 (HAL_Init 后 tick 从 0 开始)
+            stage = 1;
+            uint32_t now = HAL_GetTick();
+            return now < 20 ? (int)(20 - now) : 0;
+        }
+        case 1:
+            if (!w25q.probe() && ++tries < 3) return 10;
+            if (tries >= 3) RTT_Log("[W25Q64] Init FAILED after 3 retries!\r\n");
+            App_Pid_Load(tries < 3);
+            stage = 2;
+            return tries < 3 ? BOOT_DONE : BOOT_FAIL;
+        default:
+            return BOOT_DONE;
+    }
 }
 
 // 【新增】串口初始化
@@ -70,21 +148,120 @@ void App_Serial_Loop(void) {
     }
 }
 
+// 【新增】零偏-温度表落盘 (主循环调用)
+void App_GyroBias_Poll(void) {
+    biasStore.poll(HAL_GetTick());
+}
+
 void App_Pid_Set_Temp(uint8_t id, float kp, float ki, float kd) {
-    // 1. 更新 RAM 缓存
-    pidStore.set(id, kp, ki, kd);
+    static const char prefix[3] = {'l', 'f', 'w'};
+    if (id >= 3) return;
+
+    // 经参数表写变量 (夹紧到范围) 并立即应用到控制器
+    char name[8] = "?pid.p";
+    name[0] = prefix[id];
+    const char terms[3] = {'p', 'i', 'd'};
+    const float vals[3] = {kp, ki, kd};
+    for (int k = 0; k < 3; k++) {
+        name[5] = terms[k];
+        Param_set(Param_find(name), vals[k]);
+    }
 
-    // 2. 立即应用到电机控制器
-    LineFollower_SetPID(id, kp, ki, kd);
-    
     RTT_Log("[Tuning] Temp PID Set: P=%f I=%f D=%f (RAM only)\r\n", kp, ki, kd);
 }
 
 void App_Pid_Save(void) {
     // 写入 Flash
     // 注意：这会阻塞 CPU 约 50ms
-    pidStore.save();
-    RTT_Log("[System] PID Parameters Saved to Flash!\r\n");
+    paramStore.save();
+    CrashLog_Trace(TRACE_FLASH_SAVE, 0);
+    RTT_Log("[System] Parameters Saved to Flash!\r\n");
+}
+
+// === 参数表串口命令 (回复走 USART3) ===
+void App_Serial_Printf(const char* fmt, ...) {
+    static char line[256]; // 只在主循环用
+    va_list ap;
+    va_start(ap, fmt);
+    int len = vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    if (len <= 0) return;
+    if (len >= (int)sizeof(line)) len = sizeof(line) - 1;
+    HAL_UART_Transmit(&huart3, (uint8_t*)line, len, HAL_MAX_DELAY);
+}
+
+// newlib-nano 的 printf 不带浮点，定点 4 位小数
+static const char* param_fmt(char* buf, size_t n, float v) {
+    const char* sign = v < 0.0f ? "-" : "";
+    uint32_t x = (uint32_t)lroundf(fabsf(v) * 10000.0f);
+    snprintf(buf, n, "%s%lu.%04lu", sign, (unsigned long)(x / 10000), (unsigned long)(x % 10000));
+    return buf;
+}
+
+static void param_print(int idx) {
+    static const char* const type_names[] = {"float", "int", "bool"};
+    const param::Desc& d = Param_desc(idx);
+    char v[16], lo[16], hi[16], def[16];
+    App_Serial_Printf("%s=%s %s [%s..%s] def=%s%s\r\n", d.name, param_fmt(v, sizeof(v), Param_get(idx)),
+               type_names[(int)d.type], param_fmt(lo, sizeof(lo), d.min), param_fmt(hi, sizeof(hi), d.max),
+               param_fmt(def, sizeof(def), d.def), (d.flags & param::Persist) ? " persist" : "");
+}
+
+// "SET name value" / "GET name"
+static void App_Param_Command(char* cmd_buffer, bool set) {
+    char name[24];
+    float value = 0.0f;
+    int args = set ? sscanf(cmd_buffer + 4, "%23s %f", name, &value) : sscanf(cmd_buffer + 4, "%23s", name);
+    if (args != (set ? 2 : 1)) {
+        App_Serial_Printf("ERR usage: %s\r\n", set ? "SET <name> <value>" : "GET <name>");
+        return;
+    }
+    int idx = Param_find(name);
+    if (idx < 0) {
+        App_Serial_Printf("ERR unknown param %s\r\n", name);
+        return;
+    }
+    if (set) Param_set(idx, value);
+    param_print(idx);
+}
+
+// === 路线命令 (格式见 Routes.cpp) ===
+// "ROUTE <q>" 打印 / "ROUTESET <q> <路段...>" 下发并落盘 / "ROUTECLR <q>" 恢复内置
+static void App_Route_Command(char* cmd_buffer) {
+    static char line[224];
+    bool is_set = strncmp(cmd_buffer, "ROUTESET", 8) == 0;
+    bool is_clr = strncmp(cmd_buffer, "ROUTECLR", 8) == 0;
+    char* p = cmd_buffer + ((is_set || is_clr) ? 8 : 5);
+    int q = (int)strtol(p, &p, 10);
+    if (q < 1 || q > ROUTE_QUESTIONS) {
+        App_Serial_Printf("ERR question must be 1..%d\r\n", ROUTE_QUESTIONS);
+        return;
+    }
+
+    if (is_set || is_clr) {
+        // 正在跑的题不换路线 (控制中断持有路段指针)
+        if (UI_GetConfirmedQuestion() == q) {
+            App_Serial_Printf("ERR Q%d is running\r\n", q);
+            return;
+        }
+        RouteSegment seg[ROUTE_MAX_SEG];
+        int n = 0;
+        if (is_set) {
+            while (*p == ' ') p++;
+            n = Route_parse(p, seg, ROUTE_MAX_SEG);
+            if (n < 0) {
+                App_Serial_Printf("ERR bad route spec\r\n");
+                return;
+            }
+        }
+        Route_set((uint8_t)q, seg, (uint8_t)n);
+        SpeedProfile_Clear((uint8_t)q); // 段变了，学到的分段速度作废
+        routeStore.save();
+        CrashLog_Trace(TRACE_FLASH_SAVE, 2);
+    }
+
+    Route_format((uint8_t)q, line, sizeof(line));
+    App_Serial_Printf("ROUTE %d %s %s\r\n", q, Route_isCustom((uint8_t)q) ? "custom" : "builtin", line);
 }
 
 // === 串口命令解析 ===
@@ -93,6 +270,7 @@ void App_Pid_Save(void) {
 int Get_Pid_ID_From_Name(char* name) {
     if (strcmp(name, "LPID") == 0) return PID_ID_TURN;     // ID 0
     if (strcmp(name, "FPID") == 0) return PID_ID_FORWARD;  // ID 1 (如果有)
+    if (strcmp(name, "WPID") == 0) return PID_ID_WHEEL;    // ID 2 轮速内环
     return -1; // 未知名称
 }
 
@@ -102,10 +280,61 @@ void App_Pid_Process_Command(char* cmd_buffer) {
     
     // 1. 简单校验帧头帧尾
     size_t len = strlen(cmd_buffer);
+    CrashLog_Trace(TRACE_CMD, (uint16_t)((uint8_t)cmd_buffer[0] << 8 | (len > 1 ? (uint8_t)cmd_buffer[1] : 0)));
     if (cmd_buffer[0] != '&' || cmd_buffer[len - 1] != '#') {
         // 如果不是 & 开头，# 结尾，尝试处理 SAVE 指令
         if (strncmp(cmd_buffer, "SAVE", 4) == 0) {
             App_Pid_Save();
+        } else if (strncmp(cmd_buffer, "SET ", 4) == 0) {
+            App_Param_Command(cmd_buffer, true);
+        } else if (strncmp(cmd_buffer, "GET ", 4) == 0) {
+            App_Param_Command(cmd_buffer, false);
+        } else if (strncmp(cmd_buffer, "PARAMS", 6) == 0) {
+            for (int i = 0; i < Param_count(); i++) param_print(i);
+        } else if (strncmp(cmd_buffer, "ROUTE", 5) == 0) {
+            App_Route_Command(cmd_buffer);
+        } else if (strncmp(cmd_buffer, "DEFAULTS", 8) == 0) {
+            // 只恢复 RAM，确认后再 SAVE
+            Param_resetDefaults();
+            Param_applyAll();
+            App_Serial_Printf("OK defaults restored (RAM only)\r\n");
+        } else if (strncmp(cmd_buffer, "BENCH", 5) == 0) {
+            PidBench_Run();
+            MathBench_Run();
+        } else if (strncmp(cmd_buffer, "MAGCAL", 6) == 0) {
+            // 第一次开始磁力计标定，转几圈后再发一次结束并应用
+            if (IMU_magCalActive()) {
+                // 结果在参数表里 (imu.mag_*)，标定成功直接落盘，重启后仍参与融合
+                if (IMU_magCalFinish()) App_Pid_Save();
+            } else {
+                IMU_magCalStart();
+                RTT_Log("[MAG] calibrating, rotate the car then send MAGCAL again\r\n");
+            }
+        } else if (strncmp(cmd_buffer, "BBSTART", 7) == 0) {
+            BlackBox_Start(HAL_GetTick());
+        } else if (strncmp(cmd_buffer, "BBSTOP", 6) == 0) {
+            BlackBox_Stop();
+        } else if (strncmp(cmd_buffer, "BBDUMP", 6) == 0) {
+            // 上位机见 tools/blackbox/blackbox_dump.py
+            BlackBox_Dump();
+        } else if (strncmp(cmd_buffer, "LAPRST", 6) == 0) {
+            LapTimer_Reset();
+        } else if (strncmp(cmd_buffer, "LAP", 3) == 0) {
+            LapTimer_Report();
+        } else if (strncmp(cmd_buffer, "ILCCLR", 6) == 0) {
+            // "ILCCLR" 清全部，"ILCCLR 2" 只清 Q2
+            SpeedProfile_Clear((uint8_t)atoi(cmd_buffer + 6));
+            SpeedProfile_Report();
+        } else if (strncmp(cmd_buffer, "ILC", 3) == 0) {
+            SpeedProfile_Report();
+        } else if (strncmp(cmd_buffer, "MEM", 3) == 0) {
+            MemWatch_Report();
+        } else if (strncmp(cmd_buffer, "CRASHCLR", 8) == 0) {
+            crashStore.clear();
+            RTT_Log("[Crash] flash slot cleared\r\n");
+        } else if (strncmp(cmd_buffer, "CRASH", 5) == 0) {
+            // 上位机符号化见 tools/crash/crash_symbolize.py
+            crashStore.dump(&huart3);
         } else {
             // 格式错误或垃圾数据，直接忽略
             // RTT_Log("[Error] Invalid Frame: %s\n", cmd_buffer);
@@ -0,0 +1,32 @@
+#include "BlackBox_Interface.h"
+#include "BlackBox.hpp"
+#include "CrashLog.h"
+
+extern W25Q64 w25q;                 // App_PidConfig.cpp
+extern UART_HandleTypeDef huart3;
+
+static BlackBox blackbox(w25q);
+
+void BlackBox_Start(uint32_t now_ms) {
+    blackbox.start(now_ms);
+    CrashLog_Trace(TRACE_BLACKBOX, 1);
+}
+
+void BlackBox_Stop(void) {
+    blackbox.stop();
+    CrashLog_Trace(TRACE_BLACKBOX, 0);
+}
+
+void BlackBox_Poll(void) {
+    blackbox.poll();
+}
+
+void BlackBox_Dump(void) {
+    CrashLog_Trace(TRACE_BLACKBOX, 2);
+    uint32_t n = blackbox.dump(&huart3);
+    RTT_Log("[BlackBox] dumped %lu samples\r\n", (unsigned long)n);
+}
+
+void BlackBox_Record(BlackBoxSample& s) {
+    blackbox.record(s);
+}
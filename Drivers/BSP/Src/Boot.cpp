@@ -0,0 +1,125 @@
+#include "Boot.h"
+#include "main.h"
+#include "tim.h"
+#include "LineFollower_Interface.h"
+#include "App_PidConfig.h"
+#include "IMU.h"
+#include "OLED.h"
+#include "u8g2.h"
+
+#include "SEGGER_RTT.h"
+
+extern u8g2_t u8g2;
+
+// ================== 阶段 ==================
+// 电机/编码器 (TIM)、Flash (SPI2)、IMU (SPI6)、OLED (I2C4) 互不占用总线，可以交错进行
+enum BootStageId : uint8_t {
+    BOOT_MOTOR = 0,
+    BOOT_FLASH,
+    BOOT_SERIAL,
+    BOOT_IMU,
+    BOOT_OLED,
+    BOOT_TIMERS,
+    BOOT_STAGE_NUM
+};
+
+#define BOOT_BIT(id) (1U << (id))
+
+static int stepMotor() {
+    LineFollower_Init();
+    return BOOT_DONE;
+}
+
+static int stepSerial() {
+    App_Serial_Init();
+    return BOOT_DONE;
+}
+
+static int stepOled() {
+    u8g2Init(&u8g2);
+    u8g2_SetFont(&u8g2, u8g2_font_6x12_tf);
+    return BOOT_DONE;
+}
+
+// TIM7 里要用 IMU 和 PID 参数，TIM17 要用电机，所以放在最后
+static int stepTimers() {
+    HAL_TIM_Base_Start_IT(&htim7);
+    HAL_TIM_Base_Start_IT(&htim17);
+    return BOOT_DONE;
+}
+
+struct BootStage {
+    const char* name;
+    int (*step)(void);
+    uint32_t after;     // 依赖的阶段 (位掩码)，依赖失败也算结束
+
+    uint32_t wake_ms;
+    uint32_t t_start, t_end, busy;  // DWT 周期，相对 Boot_Run 开始
+    uint16_t calls;
+    int8_t   status;    // 0 进行中 / 1 完成 / -1 失败
+};
+
+static BootStage s_stages[BOOT_STAGE_NUM] = {
+    {"Motor",  stepMotor,        0,                                                      0, 0, 0, 0, 0, 0},
+    {"Flash",  App_Pid_InitStep, BOOT_BIT(BOOT_MOTOR),                                   0, 0, 0, 0, 0, 0},
+    {"Serial", stepSerial,       0,                                                      0, 0, 0, 0, 0, 0},
+    {"IMU",    IMU_initStep,     0,                                                      0, 0, 0, 0, 0, 0},
+    {"OLED",   stepOled,         0,                                                      0, 0, 0, 0, 0, 0},
+    {"Timers", stepTimers,       BOOT_BIT(BOOT_MOTOR) | BOOT_BIT(BOOT_FLASH) | BOOT_BIT(BOOT_IMU), 0, 0, 0, 0, 0, 0},
+};
+
+static void boot_report(uint32_t total) {
+    const uint32_t cyc_per_us = SystemCoreClock / 1000000U;
+    uint32_t serial_sum = 0;
+
+    // SEGGER_RTT_printf 的 %s 不支持宽度，阶段名放在行尾
+    RTT_Log("[Boot] start(us)   end(us)  busy(us) calls  stage\r\n");
+    for (const BootStage& s : s_stages) {
+        RTT_Log("[Boot] %9u %9u %9u %5u  %s%s\r\n",
+                (unsigned)(s.t_start / cyc_per_us), (unsigned)(s.t_end / cyc_per_us),
+                (unsigned)(s.busy / cyc_per_us), (unsigned)s.calls, s.name, s.status < 0 ? " FAILED" : "");
+        serial_sum += s.t_end - s.t_start;
+    }
+    RTT_Log("[Boot] ready in %u us (stages one by one would be %u us), %u ms since reset\r\n",
+            (unsigned)(total / cyc_per_us), (unsigned)(serial_sum / cyc_per_us), (unsigned)HAL_GetTick());
+}
+
+/*
+ * 协作式调度：每轮把依赖已满足、等待时间已到的阶段各推进一步；
+ * 所有阶段都在等时 CPU 空转到下一个 SysTick
+ */
+void Boot_Run(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    const uint32_t t0 = DWT->CYCCNT;
+
+    uint32_t finished = 0;
+    const uint32_t all = BOOT_BIT(BOOT_STAGE_NUM) - 1U;
+
+    while (finished != all) {
+        uint32_t now = HAL_GetTick();
+        for (uint8_t i = 0; i < BOOT_STAGE_NUM; i++) {
+            BootStage& s = s_stages[i];
+            if (finished & BOOT_BIT(i)) continue;
+            if ((s.after & finished) != s.after) continue;
+            if ((int32_t)(now - s.wake_ms) < 0) continue;
+
+            uint32_t c0 = DWT->CYCCNT - t0;
+            if (s.calls == 0) s.t_start = c0;
+            int r = s.step();
+            uint32_t c1 = DWT->CYCCNT - t0;
+            s.busy += c1 - c0;
+            s.calls++;
+
+            if (r == BOOT_DONE || r == BOOT_FAIL) {
+                s.status = (r == BOOT_DONE) ? 1 : -1;
+                s.t_end = c1;
+                finished |= BOOT_BIT(i);
+            } else {
+                s.wake_ms = HAL_GetTick() + (uint32_t)r;
+            }
+        }
+    }
+
+    boot_report(DWT->CYCCNT - t0);
+}
@@ -0,0 +1,146 @@
+#include "CrashLog.h"
+#include "main.h"
+#include <cstddef>
+
+extern uint32_t _estack;            // 链接脚本：DTCM 栈顶
+
+#define CRASH_STACK_BEGIN 0x20000000U  // 栈在 DTCM (不走 D-Cache，复位前不用 clean)
+
+// .noinit 段启动代码不清零，软复位后还在；上电后是随机值，靠 magic + 累加和判断
+__attribute__((section(".noinit"))) static CrashRecord s_crash;
+
+static CrashTraceEvent s_trace[CRASH_TRACE_LEN];
+static uint32_t s_trace_head = 0;
+
+static_assert((CRASH_TRACE_LEN & (CRASH_TRACE_LEN - 1)) == 0, "CRASH_TRACE_LEN must be power of 2");
+
+static uint32_t crash_sum(const CrashRecord* r) {
+    const uint32_t* w = (const uint32_t*)r;
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < offsetof(CrashRecord, sum) / 4; i++) sum += w[i];
+    return sum;
+}
+
+void CrashLog_Trace(uint16_t id, uint16_t arg) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    CrashTraceEvent& e = s_trace[s_trace_head & (CRASH_TRACE_LEN - 1)];
+    e.t_ms = HAL_GetTick();
+    e.id = id;
+    e.arg = arg;
+    s_trace_head++;
+    __set_PRIMASK(primask);
+}
+
+// 故障状态寄存器、栈窗口、事件队列，最后盖上 magic 和累加和
+static void crash_capture(CrashRecord* r, uint32_t sp) {
+    r->t_ms  = HAL_GetTick();
+    r->sp    = sp;
+    r->cfsr  = SCB->CFSR;
+    r->hfsr  = SCB->HFSR;
+    r->mmfar = SCB->MMFAR;
+    r->bfar  = SCB->BFAR;
+
+    // 只在栈范围内读：栈溢出时 sp 可能已经越界，再去读会在 HardFault 里再 fault 一次
+    uint32_t top = (uint32_t)&_estack;
+    uint32_t n = 0;
+    if (sp >= CRASH_STACK_BEGIN && sp < top) {
+        n = (top - sp) / 4;
+        if (n > CRASH_STACK_WORDS) n = CRASH_STACK_WORDS;
+        for (uint32_t i = 0; i < n; i++) r->stack[i] = ((const uint32_t*)sp)[i];
+    }
+    r->stack_words = n;
+
+    uint32_t count = s_trace_head < CRASH_TRACE_LEN ? s_trace_head : CRASH_TRACE_LEN;
+    uint32_t first = s_trace_head - count;
+    for (uint32_t i = 0; i < count; i++) r->trace[i] = s_trace[(first + i) & (CRASH_TRACE_LEN - 1)];
+    r->trace_count = count;
+
+    r->magic = CRASH_MAGIC;
+    r->sum = crash_sum(r);
+}
+
+// 现场已经留在 RAM 里，软复位让车重新起来，下次上电由 CrashStorage 落盘
+[[noreturn]] static void crash_reset() {
+    __DSB();
+    NVIC_SystemReset();
+    while (1) {}
+}
+
+// naked 函数里只能有基本汇编：没有函数序言，MSP 还指着异常帧
+__attribute__((naked)) void CrashLog_FaultEntry(void) {
+    __asm volatile(
+        "tst lr, #4        \n"
+        "ite eq            \n"
+        "mrseq r0, msp     \n"
+        "mrsne r0, psp     \n"
+        "mov r1, lr        \n"
+        "b CrashLog_Fault  \n");
+}
+
+// 四个故障向量 (启动文件里是弱符号) 共用同一个入口，类型由 CrashLog_Fault 读 VECTACTIVE 区分
+extern "C" {
+void HardFault_Handler(void) __attribute__((alias("CrashLog_FaultEntry")));
+void MemManage_Handler(void) __attribute__((alias("CrashLog_FaultEntry")));
+void BusFault_Handler(void) __attribute__((alias("CrashLog_FaultEntry")));
+void UsageFault_Handler(void) __attribute__((alias("CrashLog_FaultEntry")));
+}
+
+void CrashLog_Fault(uint32_t* frame, uint32_t exc_return) {
+    __disable_irq();
+    CrashRecord* r = &s_crash;
+    r->type = SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk;
+    r->exc_return = exc_return;
+
+    uint32_t sp = (uint32_t)frame;
+    if (sp >= CRASH_STACK_BEGIN && sp + 32 <= (uint32_t)&_estack) {
+        r->r0 = frame[0];
+        r->r1 = frame[1];
+        r->r2 = frame[2];
+        r->r3 = frame[3];
+        r->r12 = frame[4];
+        r->lr = frame[5];
+        r->pc = frame[6];
+        r->xpsr = frame[7];
+    } else {
+        r->r0 = r->r1 = r->r2 = r->r3 = r->r12 = r->lr = r->pc = r->xpsr = 0;
+    }
+    crash_capture(r, sp);
+    crash_reset();
+}
+
+void CrashLog_Error(uint32_t caller) {
+    __disable_irq();
+    CrashRecord* r = &s_crash;
+    r->type = CRASH_ERROR_HANDLER;
+    r->exc_return = 0;
+    r->r0 = r->r1 = r->r2 = r->r3 = r->r12 = r->xpsr = 0;
+    r->lr = caller;
+    r->pc = caller;
+    crash_capture(r, __get_MSP());
+    crash_reset();
+}
+
+int CrashLog_Valid(const CrashRecord* r) {
+    return r->magic == CRASH_MAGIC && r->sum == crash_sum(r)
+        && r->stack_words <= CRASH_STACK_WORDS && r->trace_count <= CRASH_TRACE_LEN;
+}
+
+const CrashRecord* CrashLog_Pending(void) {
+    return CrashLog_Valid(&s_crash) ? &s_crash : nullptr;
+}
+
+void CrashLog_ClearPending(void) {
+    s_crash.magic = 0;
+}
+
+const char* CrashLog_TypeName(uint32_t type) {
+    switch (type) {
+        case CRASH_HARDFAULT:     return "HardFault";
+        case CRASH_MEMMANAGE:     return "MemManage";
+        case CRASH_BUSFAULT:      return "BusFault";
+        case CRASH_USAGEFAULT:    return "UsageFault";
+        case CRASH_ERROR_HANDLER: return "Error_Handler";
+        default:                  return "Unknown";
+    }
+}
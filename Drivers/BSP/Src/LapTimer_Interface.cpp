@@ -0,0 +1,82 @@
+#include "LapTimer_Interface.h"
+#include "LapTimer.hpp"
+#include "App_PidConfig.h"
+#include "main.h"
+#include <cmath>
+#include <cstdio>
+
+static LapTimer laps;
+
+void LapTimer_Begin(uint8_t q, bool has_route, uint32_t now_ms) {
+    laps.begin(q, has_route, now_ms);
+}
+
+void LapTimer_Segment(uint8_t idx, uint8_t drive, bool terminal, uint32_t now_ms) {
+    laps.segment(idx, drive, terminal, now_ms);
+}
+
+void LapTimer_Sample(float err, bool saturated, uint32_t dt_ms) {
+    laps.sample(err, saturated, dt_ms);
+}
+
+void LapTimer_Lost(uint32_t now_ms) {
+    laps.lost(now_ms);
+}
+
+uint32_t LapTimer_LastLap(SegmentSplit* out, uint8_t max, uint8_t& n, uint8_t& q, bool& aborted) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    n = laps.lastSplits(out, max, q, aborted);
+    uint32_t seq = laps.lapSeq();
+    __set_PRIMASK(primask);
+    return seq;
+}
+
+void LapTimer_Summary(uint8_t q, LapSummary& out, uint32_t& elapsed_ms) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    out = laps.summary(q);
+    elapsed_ms = laps.question() == q ? laps.elapsed(HAL_GetTick()) : 0;
+    __set_PRIMASK(primask);
+}
+
+void LapTimer_Reset(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    laps.reset();
+    __set_PRIMASK(primask);
+}
+
+// newlib-nano 的 printf 不带浮点：毫秒按 秒.毫秒 打印
+#define SEC(ms) (unsigned long)((ms) / 1000), (unsigned long)((ms) % 1000)
+
+/*
+ * LAP Q<n> laps=.. last=s best=s mean=s
+ * SPLIT Q<n> <段> <Y|L|S> t=s err=x100 sat=s [LOST]   (最近一圈，丢线作废的圈也给)
+ */
+void LapTimer_Report(void) {
+    static SegmentSplit splits[ROUTE_MAX_SEG];
+    LapSummary sum[ROUTE_QUESTIONS];
+    uint8_t n, q;
+    bool aborted;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    for (uint8_t i = 0; i < ROUTE_QUESTIONS; i++) sum[i] = laps.summary(i + 1);
+    n = laps.lastSplits(splits, ROUTE_MAX_SEG, q, aborted);
+    __set_PRIMASK(primask);
+
+    for (uint8_t i = 0; i < ROUTE_QUESTIONS; i++) {
+        const LapSummary& s = sum[i];
+        if (s.laps == 0) continue;
+        uint32_t mean = s.total_ms / s.laps;
+        App_Serial_Printf("LAP Q%u laps=%lu last=%lu.%03lu best=%lu.%03lu mean=%lu.%03lu\r\n",
+                 (unsigned)(i + 1), (unsigned long)s.laps, SEC(s.last_ms), SEC(s.best_ms), SEC(mean));
+    }
+    for (uint8_t i = 0; i < n; i++) {
+        const SegmentSplit& s = splits[i];
+        App_Serial_Printf("SPLIT Q%u %u %c t=%lu.%03lu err=%ld sat=%lu.%03lu%s\r\n", (unsigned)q, (unsigned)i, "YLS"[s.drive % 3],
+                 SEC(s.ms), (long)lroundf(s.peak_err * 100.0f), SEC(s.sat_ms), s.lost ? " LOST" : "");
+    }
+    App_Serial_Printf("LAPEND\r\n");
+}
@@ -1,4 +1,6 @@
 #include "LineFollower.h"
+#include "BlackBox_Interface.h"
+#include "CrashLog.h"
 #include "tim.h"
 #include "ui.h"
 
@@ -14,7 +16,9 @@ void LineFollower_Init(void) {
     // 假设电机接在 TIM1
     // 左电机: CH1, CH2
     // 右电机: CH3, CH4
-    static LineFollower static_instance(&htim1, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4);
+    // 编码器: 左 TIM2, 右 TIM3
+    static LineFollower static_instance(&htim1, TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4,
+                                        &htim2, &htim3);
     controller = &static_instance;
 
     // 设置基础速度 (0.0 - 1.0)
@@ -31,12 +35,34 @@ void LineFollower_OnTimer(void) {
         uint8_t q = UI_GetConfirmedQuestion();
 
         if (q != lastQ) {
-            controller->onQuestionChanged(q);
-            if (q == 2) controller->q2_start_from_A(); // A点提示一次 + 锁航向
+            controller->onQuestionChanged(q); // 取该题路线，执行第一段的进入动作
+            CrashLog_Trace(TRACE_QUESTION, q);
+            if (q != 0) BlackBox_Start(HAL_GetTick()); // 每次确认题号开一段新日志
             lastQ = q;
         }
 
-        controller->updateISR(q);
+        controller->updateISR();
+
+        BlackBoxSample s;
+        controller->snapshot(s);
+        BlackBox_Record(s);
+    }
+}
+
+// C 接口：EXTI 回调 (传感器 PA8/PA10/PA11/PA12/PA15，编码器 A 相 PA0/PC6)
+void LineFollower_OnEdge(uint16_t pin) {
+    if (controller == nullptr) return;
+    if (pin & LF_SENSOR_MASK) {
+        controller->onEdgeISR();
+    } else {
+        controller->onEncoderEdgeISR(pin);
+    }
+}
+
+// C 接口：TIM17 1kHz 轮速内环
+void LineFollower_OnSpeedLoop(void) {
+    if (controller != nullptr) {
+        controller->speedLoopISR();
     }
 }
 
@@ -54,6 +80,20 @@ void LineFollower_SetSpeed(float speed) {
     }
 }
 
+// 循线 PID 微分低通系数 (参数表 turn.dalpha)
+void LineFollower_SetTurnDAlpha(float alpha) {
+    if (controller != nullptr) {
+        controller->setTurnDAlpha(alpha);
+    }
+}
+
+// 开环 / 轮速闭环切换 (参数表 speed.loop)
+void LineFollower_SetClosedLoop(bool en) {
+    if (controller != nullptr) {
+        controller->setClosedLoop(en);
+    }
+}
+
 // 重置航向参考接口
 void LineFollower_SetYaw() {
     if (controller != nullptr) {
@@ -66,4 +106,11 @@ void LineFollower_SetYawRef(float yaw_deg) {
     if (controller != nullptr) {
         controller->setYawRefDeg(yaw_deg);
     }
-}
\ No newline at end of file
+}
+
+// 读取里程计位姿快照 (主循环等非控制上下文)
+void LineFollower_GetPose(struct OdomPose* out) {
+    if (controller != nullptr && out != nullptr) {
+        *out = controller->odometry().snapshot();
+    }
+}
@@ -0,0 +1,120 @@
+#include "LineSampler.hpp"
+
+#include <cstring>
+
+using namespace line_sampler_detail;
+
+// DMA1 访问不到 DTCM，缓冲放 AXI SRAM (.RAM 段，MPU 配成不可缓存)
+static uint16_t ls_dma_buffer[LS_BUF_LEN] __attribute__((section(".RAM"), aligned(32)));
+
+void LineSampler::begin() {
+    // DWT 周期计数器用作时间戳
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    _cyc_per_sample = SystemCoreClock / LS_SAMPLE_RATE_HZ;
+
+    // .RAM 段启动时不清零，窗口计数要求初始内容为 0
+    std::memset(ls_dma_buffer, 0, sizeof(ls_dma_buffer));
+    _tail = 0;
+    _sum  = 0;
+    _maj  = 0;
+    _out  = {};
+
+    // === TIM6: 只产生更新事件，不开中断 ===
+    __HAL_RCC_TIM6_CLK_ENABLE();
+    // APB1 分频不为 1 时定时器时钟为 PCLK1 x2
+    uint32_t tim_clk = HAL_RCC_GetPCLK1Freq() * 2U;
+
+    _htim.Instance = TIM6;
+    _htim.Init.Prescaler = 0;
+    _htim.Init.CounterMode = TIM_COUNTERMODE_UP;
+    _htim.Init.Period = tim_clk / LS_SAMPLE_RATE_HZ - 1U;
+    _htim.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+    if (HAL_TIM_Base_Init(&_htim) != HAL_OK) {
+        Error_Handler();
+    }
+
+    // === DMA1_Stream1: 传感器端口 IDR -> 环形缓冲 (半字) ===
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    _hdma.Instance = DMA1_Stream1;
+    _hdma.Init.Request = DMA_REQUEST_TIM6_UP;
+    _hdma.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    _hdma.Init.PeriphInc = DMA_PINC_DISABLE;
+    _hdma.Init.MemInc = DMA_MINC_ENABLE;
+    _hdma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    _hdma.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    _hdma.Init.Mode = DMA_CIRCULAR;
+    _hdma.Init.Priority = DMA_PRIORITY_HIGH;
+    _hdma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&_hdma) != HAL_OK) {
+        Error_Handler();
+    }
+
+    HAL_DMA_Start(&_hdma, (uint32_t)&LineSensors::port()->IDR, (uint32_t)ls_dma_buffer, LS_BUF_LEN);
+    __HAL_TIM_ENABLE_DMA(&_htim, TIM_DMA_UPDATE);
+    __HAL_TIM_ENABLE(&_htim);
+}
+
+// 落后太多 (ISR 被长时间阻塞) 时，旧采样点已被 DMA 覆盖，用最近一个窗口重建计数
+void LineSampler::resync(uint32_t head) {
+    _sum = 0;
+    uint32_t idx = (head + LS_BUF_LEN - LS_MAJORITY_WIN) % LS_BUF_LEN;
+    for (uint32_t n = 0; n < LS_MAJORITY_WIN; n++) {
+        _sum += spread(ls_dma_buffer[idx]);
+        idx = (idx + 1U) % LS_BUF_LEN;
+    }
+    _tail = head;
+}
+
+const LineSample& LineSampler::update() {
+    // 同时读取时间和 DMA 位置，作为本批采样点的时间基准
+    uint32_t now  = DWT->CYCCNT;
+    uint32_t head = LS_BUF_LEN - __HAL_DMA_GET_COUNTER(&_hdma);
+    if (head >= LS_BUF_LEN) head = 0;
+
+    uint32_t pending = (head + LS_BUF_LEN - _tail) % LS_BUF_LEN;
+
+    _out.rose = false;
+    _out.fell = false;
+
+    if (pending > LS_BUF_LEN - 2U * LS_MAJORITY_WIN) {
+        resync(head);
+        pending = 0;
+        _maj = (_sum + BIAS_ALL) & MSB_ALL;
+    }
+
+    bool has_line = (_maj != 0);
+    uint32_t idx = _tail;
+    uint32_t old = (idx + LS_BUF_LEN - LS_MAJORITY_WIN) % LS_BUF_LEN;
+
+    for (uint32_t n = 0; n < pending; n++) {
+        _sum += spread(ls_dma_buffer[idx]);
+        _sum -= spread(ls_dma_buffer[old]);
+
+        uint32_t maj = (_sum + BIAS_ALL) & MSB_ALL;
+        if (maj != _maj) {
+            _maj = maj;
+            bool now_line = (maj != 0);
+            if (now_line != has_line) {
+                has_line = now_line;
+                if (now_line) _out.rose = true;
+                else          _out.fell = true;
+                // 第 n 个点距离最新点 (pending - 1 - n) 个采样周期
+                _out.edge_cyc = now - (pending - 1U - n) * _cyc_per_sample;
+            }
+        }
+
+        if (++idx >= LS_BUF_LEN) idx = 0;
+        if (++old >= LS_BUF_LEN) old = 0;
+    }
+    _tail = idx;
+
+    // 多数表决结果还原成 IDR 位格式
+    uint16_t raw = 0;
+    for (uint32_t k = 0; k < LANE_NUM; k++) {
+        if (_maj & (1U << (k * LANE_BITS + LANE_BITS - 1U))) raw |= LineSensors::pins[k];
+    }
+    _out.raw = raw;
+    _out.stamp_cyc = now;
+    return _out;
+}
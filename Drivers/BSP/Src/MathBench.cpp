@@ -0,0 +1,90 @@
+#include "App_PidConfig.h"
+#include "attitude_filter.h"
+#include "fast_math.h"
+#include "main.h"
+#include "SEGGER_RTT.h"
+#include <cmath>
+
+// 串口 "BENCH" 触发：newlib atan2f/asinf 与 fast_math.h 近似版的周期数和最大误差，
+// 以及 Mahony / Madgwick 两个姿态滤波后端每次更新的周期数
+#define MATH_BENCH_N  256U
+
+namespace {
+
+float bench_x[MATH_BENCH_N];
+float bench_y[MATH_BENCH_N];
+volatile float bench_sink;
+
+template <typename Fn>
+uint32_t timeLoop(Fn&& fn) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t t0 = DWT->CYCCNT;
+    float acc = 0.0f;
+    for (uint32_t k = 0; k < MATH_BENCH_N; k++) acc += fn(k);
+    uint32_t cyc = DWT->CYCCNT - t0;
+    __set_PRIMASK(primask);
+    bench_sink = acc; // 防止整个循环被优化掉
+    return cyc;
+}
+
+// 同一组合成数据 (静止水平 + 小幅晃动) 分别喂给两个后端，返回总周期数和最终航向 (rad)
+template <typename F, typename Init, typename Update>
+uint32_t timeFilter(F& f, Init init, Update update, float& yaw) {
+    init(&f);
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t t0 = DWT->CYCCNT;
+    for (uint32_t k = 0; k < MATH_BENCH_N; k++) {
+        const float wobble = 0.2f * bench_y[k];           // rad/s
+        update(&f, wobble, -wobble, 0.0f,
+               50.0f * bench_y[k], 50.0f * bench_x[k], 1000.0f, // mg
+               0.0f, 0.0f, 0.0f, 0.02f);
+    }
+    uint32_t cyc = DWT->CYCCNT - t0;
+    __set_PRIMASK(primask);
+    yaw = fast_atan2f(2.0f * (f.q[1] * f.q[2] + f.q[0] * f.q[3]),
+                      1.0f - 2.0f * (f.q[2] * f.q[2] + f.q[3] * f.q[3]));
+    return cyc;
+}
+
+} // namespace
+
+void MathBench_Run(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // 一整圈的方向 + [-1, 1] 内均匀分布的 asin 输入
+    for (uint32_t k = 0; k < MATH_BENCH_N; k++) {
+        float t = -FAST_MATH_PI + (2.0f * FAST_MATH_PI) * k / MATH_BENCH_N;
+        bench_x[k] = cosf(t);
+        bench_y[k] = sinf(t);
+    }
+
+    uint32_t c_atan2  = timeLoop([](uint32_t k) { return atan2f(bench_y[k], bench_x[k]); });
+    uint32_t c_fatan2 = timeLoop([](uint32_t k) { return fast_atan2f(bench_y[k], bench_x[k]); });
+    uint32_t c_asin   = timeLoop([](uint32_t k) { return asinf(bench_y[k]); });
+    uint32_t c_fasin  = timeLoop([](uint32_t k) { return fast_asinf(bench_y[k]); });
+
+    float err_atan2 = 0.0f, err_asin = 0.0f;
+    for (uint32_t k = 0; k < MATH_BENCH_N; k++) {
+        float e = fabsf(fast_atan2f(bench_y[k], bench_x[k]) - atan2f(bench_y[k], bench_x[k]));
+        if (e > FAST_MATH_PI) e = 2.0f * FAST_MATH_PI - e; // ±π 处两边取值
+        err_atan2 = fmaxf(err_atan2, e);
+        err_asin = fmaxf(err_asin, fabsf(fast_asinf(bench_y[k]) - asinf(bench_y[k])));
+    }
+
+    const float RAD_TO_DEG = 180.0f / FAST_MATH_PI;
+    RTT_Log("[Bench] atan2 cycles/call: libm=%u fast=%u | asin: libm=%u fast=%u\r\n",
+            c_atan2 / MATH_BENCH_N, c_fatan2 / MATH_BENCH_N, c_asin / MATH_BENCH_N, c_fasin / MATH_BENCH_N);
+    RTT_Log("[Bench] max err (deg): atan2=%f asin=%f\r\n", err_atan2 * RAD_TO_DEG, err_asin * RAD_TO_DEG);
+
+    MahonyFilter mahony;
+    MadgwickFilter madgwick;
+    float yaw_mahony, yaw_madgwick;
+    uint32_t c_mahony = timeFilter(mahony, Mahony_init, Mahony_update, yaw_mahony);
+    uint32_t c_madgwick = timeFilter(madgwick, Madgwick_init, Madgwick_update, yaw_madgwick);
+    RTT_Log("[Bench] attitude cycles/update: mahony=%u madgwick=%u | yaw drift (deg): %f %f\r\n",
+            c_mahony / MATH_BENCH_N, c_madgwick / MATH_BENCH_N,
+            yaw_mahony * RAD_TO_DEG, yaw_madgwick * RAD_TO_DEG);
+}
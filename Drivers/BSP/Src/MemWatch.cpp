@@ -0,0 +1,137 @@
+#include "MemWatch.h"
+#include "App_PidConfig.h"
+#include "main.h"
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+#include "SEGGER_RTT.h"
+
+/*
+ * DTCM 布局 (见链接脚本)：.data | .bss | .noinit | newlib 堆 (_end 往上) ...... 栈 (_estack 往下)
+ * 堆和栈之间涂成固定值，扫描第一个被改写的字就是栈到过的最深处
+ */
+extern "C" {
+extern uint8_t _end;
+extern uint8_t _estack;
+// sysmem.c 里的 _sbrk 统计
+extern uint32_t sbrk_calls;
+extern uint32_t sbrk_fails;
+uint8_t* sbrk_break(void);
+}
+
+static uint32_t s_paint_top = 0;        // 涂色区上界 (不含)
+static uint32_t s_stack_low = 0;        // 扫到的栈最深地址
+static uint32_t s_last_scan_ms = 0;
+static bool     s_warned = false;
+
+static volatile uint32_t s_isr_min_sp = 0xFFFFFFFFU;     // 中断里采到的最深 MSP
+static volatile uint32_t s_nested_min_sp = 0xFFFFFFFFU;  // 其中打断了别的中断时的最深 MSP
+
+// operator new/delete 计数 (std::string 等 C++ 分配；printf 走 _malloc_r 不经过这里，只体现在 sbrk 上)
+static uint32_t s_news = 0, s_deletes = 0;
+static uint32_t s_live = 0, s_live_peak = 0;
+static uint32_t s_bytes = 0, s_bytes_peak = 0;
+
+// main() 开头调用，此时栈只用了几十字节；留 64 字节给本函数自己
+void MemWatch_PaintStack(void) {
+    uint32_t* p = (uint32_t*)(((uint32_t)sbrk_break() + 3U) & ~3U);
+    uint32_t* top = (uint32_t*)((__get_MSP() - 64U) & ~3U);
+    s_paint_top = (uint32_t)top;
+    s_stack_low = s_paint_top;
+    while (p < top) *p++ = MEMWATCH_PAINT_WORD;
+}
+
+// 从当前堆顶往上找第一个被改写的字 (堆顶以下是堆自己的数据)
+static uint32_t scan_stack_low(void) {
+    const uint32_t* p = (const uint32_t*)(((uint32_t)sbrk_break() + 3U) & ~3U);
+    const uint32_t* end = (const uint32_t*)s_stack_low;
+    while (p < end && *p == MEMWATCH_PAINT_WORD) p++;
+    return (uint32_t)p;
+}
+
+void MemWatch_Poll(uint32_t now_ms) {
+    if (s_paint_top == 0) return;
+    if (now_ms - s_last_scan_ms < MEMWATCH_SCAN_MS) return;
+    s_last_scan_ms = now_ms;
+
+    uint32_t low = scan_stack_low();
+    if (low < s_stack_low) s_stack_low = low;
+
+    uint32_t brk = (uint32_t)sbrk_break();
+    uint32_t gap = s_stack_low > brk ? s_stack_low - brk : 0;
+    if (!s_warned && gap < MEMWATCH_WARN_GAP) {
+        s_warned = true;
+        RTT_Log("[Mem] WARNING: only %u bytes between heap and stack\r\n", (unsigned)gap);
+    }
+}
+
+void MemWatch_SampleIsr(void) {
+    uint32_t sp = __get_MSP();
+    if (sp < s_isr_min_sp) s_isr_min_sp = sp;
+    // RETTOBASE = 0：返回后还有别的异常在执行，即本中断打断了另一个中断
+    if ((SCB->ICSR & SCB_ICSR_RETTOBASE_Msk) == 0 && sp < s_nested_min_sp) s_nested_min_sp = sp;
+}
+
+void MemWatch_Report(void) {
+    s_last_scan_ms -= MEMWATCH_SCAN_MS;  // 立即扫一次
+    MemWatch_Poll(HAL_GetTick());
+
+    const uint32_t top = (uint32_t)&_estack;
+    const uint32_t heap_base = (uint32_t)&_end;
+    const uint32_t brk = (uint32_t)sbrk_break();
+    const uint32_t sp = __get_MSP();
+
+    App_Serial_Printf("MEM stack now=%lu peak=%lu bytes (top 0x%08lx)\r\n",
+             (unsigned long)(top - sp), (unsigned long)(top - s_stack_low), (unsigned long)top);
+#if MEMWATCH_ISR_SAMPLE
+    App_Serial_Printf("MEM isr sampled peak=%lu nested peak=%lu bytes\r\n",
+             (unsigned long)(s_isr_min_sp == 0xFFFFFFFFU ? 0 : top - s_isr_min_sp),
+             (unsigned long)(s_nested_min_sp == 0xFFFFFFFFU ? 0 : top - s_nested_min_sp));
+#endif
+    App_Serial_Printf("MEM heap break=%lu bytes (base 0x%08lx) sbrk calls=%lu fails=%lu\r\n",
+             (unsigned long)(brk - heap_base), (unsigned long)heap_base,
+             (unsigned long)sbrk_calls, (unsigned long)sbrk_fails);
+    App_Serial_Printf("MEM new=%lu delete=%lu live=%lu/%lu peak, bytes=%lu/%lu peak\r\n",
+             (unsigned long)s_news, (unsigned long)s_deletes, (unsigned long)s_live,
+             (unsigned long)s_live_peak, (unsigned long)s_bytes, (unsigned long)s_bytes_peak);
+    App_Serial_Printf("MEM headroom %lu bytes between heap break and deepest stack\r\n",
+             (unsigned long)(s_stack_low > brk ? s_stack_low - brk : 0));
+}
+
+// ================== C++ 分配计数 ==================
+// -fno-exceptions：分配失败直接进 Error_Handler (会留下崩溃现场)
+void* operator new(std::size_t n) {
+    void* p = std::malloc(n ? n : 1);
+    if (p == nullptr) Error_Handler();
+    s_news++;
+    if (++s_live > s_live_peak) s_live_peak = s_live;
+    s_bytes += malloc_usable_size(p);
+    if (s_bytes > s_bytes_peak) s_bytes_peak = s_bytes;
+    return p;
+}
+
+void* operator new[](std::size_t n) {
+    return operator new(n);
+}
+
+void operator delete(void* p) noexcept {
+    if (p == nullptr) return;
+    s_deletes++;
+    s_live--;
+    s_bytes -= malloc_usable_size(p);
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    operator delete(p);
+}
@@ -0,0 +1,95 @@
+#include "MotorOutput.hpp"
+
+// CCR1~CCR4 的 burst 源数据；DMA1 访问不到 DTCM，放 AXI SRAM (.RAM 段，不可缓存)
+static uint32_t motor_burst[4] __attribute__((section(".RAM"), aligned(32)));
+
+static constexpr uint32_t chIndex(uint32_t ch) { return ch >> 2; } // TIM_CHANNEL_1..4 = 0x0/0x4/0x8/0xC
+
+void MotorOutput::begin() {
+    _arr = __HAL_TIM_GET_AUTORELOAD(_htim);
+
+    // CCR 预装载：burst 写进影子寄存器，下一个更新事件四路一起生效
+    _htim->Instance->CCMR1 |= TIM_CCMR1_OC1PE | TIM_CCMR1_OC2PE;
+    _htim->Instance->CCMR2 |= TIM_CCMR2_OC3PE | TIM_CCMR2_OC4PE;
+
+    // === DMA1_Stream2: 内存 -> TIM1->DMAR (字)，每次提交 4 个字 ===
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    _hdma.Instance = DMA1_Stream2;
+    _hdma.Init.Request = DMA_REQUEST_TIM1_UP;
+    _hdma.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    _hdma.Init.PeriphInc = DMA_PINC_DISABLE;
+    _hdma.Init.MemInc = DMA_MINC_ENABLE;
+    _hdma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    _hdma.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    _hdma.Init.Mode = DMA_NORMAL;
+    _hdma.Init.Priority = DMA_PRIORITY_VERY_HIGH;
+    _hdma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&_hdma) != HAL_OK) {
+        Error_Handler();
+    }
+
+    auto* stream = reinterpret_cast<DMA_Stream_TypeDef*>(_hdma.Instance);
+    stream->PAR  = (uint32_t)&_htim->Instance->DMAR;
+    stream->M0AR = (uint32_t)motor_burst;
+
+    // DMAR 访问从 CCR1 开始连续 4 个寄存器
+    _htim->Instance->DCR = TIM_DMABASE_CCR1 | TIM_DMABURSTLENGTH_4TRANSFERS;
+    __HAL_TIM_ENABLE_DMA(_htim, TIM_DMA_UPDATE);
+
+    // 停车值先直接写一遍，PWM 启动时就是确定状态
+    for (uint32_t k = 0; k < 4; k++) {
+        __HAL_TIM_SET_COMPARE(_htim, k << 2, _arr);
+    }
+    HAL_TIM_PWM_Start(_htim, _l_a);
+    HAL_TIM_PWM_Start(_htim, _l_b);
+    HAL_TIM_PWM_Start(_htim, _r_a);
+    HAL_TIM_PWM_Start(_htim, _r_b);
+
+    stop();
+}
+
+// 反相驱动：比较值 = (1 - |speed|) * ARR，另一路拉满
+void MotorOutput::fill(uint32_t* ccr, uint32_t ch_a, uint32_t ch_b, float speed) const {
+    if (speed > 1.0f) speed = 1.0f;
+    if (speed < -1.0f) speed = -1.0f;
+
+    if (speed >= 0.0f) {
+        ccr[chIndex(ch_a)] = _arr;
+        ccr[chIndex(ch_b)] = (uint32_t)((1.0f - speed) * _arr);
+    } else {
+        ccr[chIndex(ch_a)] = (uint32_t)((1.0f + speed) * _arr);
+        ccr[chIndex(ch_b)] = _arr;
+    }
+}
+
+void MotorOutput::set(float left, float right) {
+    uint32_t ccr[4];
+    fill(ccr, _l_a, _l_b, left);
+    fill(ccr, _r_a, _r_b, right);
+    commit(ccr);
+    _left = left > 1.0f ? 1.0f : (left < -1.0f ? -1.0f : left);
+    _right = right > 1.0f ? 1.0f : (right < -1.0f ? -1.0f : right);
+}
+
+void MotorOutput::commit(const uint32_t* ccr) {
+    auto* stream = reinterpret_cast<DMA_Stream_TypeDef*>(_hdma.Instance);
+
+    // TIM17 内环可能打断 TIM7/EXTI 里的提交，整个过程关中断 (< 1us)
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (uint32_t k = 0; k < 4; k++) motor_burst[k] = ccr[k];
+    __DSB();
+
+    // 上一次提交还挂着 (没等到更新事件)：不能撤下重装。TIM1 的 DMAR 按 DCR 的 burst 计数依次落到
+    // CCR1..CCR4，这个计数只在一整个 burst 搬完时归零；中途停 DMA 再从头搬，新 burst 会从断点接着写，
+    // 比较值错位到别的通道。挂着的 burst 在更新事件才从 motor_burst 取数，刚改的值会被它带走。
+    // (恰好在搬运的几百 ns 内改写时，这一个 PWM 周期是新旧两组值的混合，各自仍落在正确的通道上)
+    if (!(stream->CR & DMA_SxCR_EN)) {
+        DMA1->LIFCR = DMA_LIFCR_CTCIF2 | DMA_LIFCR_CHTIF2 | DMA_LIFCR_CTEIF2 | DMA_LIFCR_CDMEIF2 | DMA_LIFCR_CFEIF2;
+        stream->NDTR = 4;
+        stream->CR |= DMA_SxCR_EN;
+    }
+
+    __set_PRIMASK(primask);
+}
@@ -0,0 +1,198 @@
+#include "Params.hpp"
+#include "PidStorage.hpp"
+#include "SensorArray.hpp"
+#include "LineFollower.h"
+#include "LineFollower_Interface.h"
+#include "attitude_filter.h"
+#include "IMU.h"
+#include <cmath>
+#include <cstring>
+
+// ================== 参数变量 ==================
+// 上电由 Param_resetDefaults() 按表写默认值，再由 ParamStorage 覆盖 Flash 里存的
+namespace prm {
+float   lpid_p, lpid_i, lpid_d;
+float   fpid_p, fpid_i, fpid_d;
+float   wpid_p, wpid_i, wpid_d;
+float   speed_straight;
+float   speed_arc;
+float   turn_d_alpha;
+bool    speed_loop;
+int32_t line_w[5];
+int32_t route_laps;
+bool    ilc_enable;
+float   ilc_err_line, ilc_err_yaw;
+float   ilc_sat_frac;
+float   ilc_step, ilc_backoff;
+float   ilc_vmin, ilc_vmax;
+bool    gs_enable;
+float   gs_v[GS_POINTS];
+PidGains lpid_gs[GS_POINTS - 1];
+PidGains fpid_gs[GS_POINTS - 1];
+bool    mp_enable;
+float   mp_acc, mp_jerk;
+float   mp_creep;
+float   mp_turn_slew;
+} // namespace prm
+
+static_assert(LineSensors::count == 5, "line.w* entries assume 5 sensors");
+static_assert(GS_POINTS == 3, "gs.* / lpid1/2 / fpid1/2 entries assume 3 schedule points");
+
+// ================== 修改后回调 ==================
+static void applyTurnPid()  { LineFollower_SetPID(PID_ID_TURN, prm::lpid_p, prm::lpid_i, prm::lpid_d); }
+static void applyFwdPid()   { LineFollower_SetPID(PID_ID_FORWARD, prm::fpid_p, prm::fpid_i, prm::fpid_d); }
+static void applyWheelPid() { LineFollower_SetPID(PID_ID_WHEEL, prm::wpid_p, prm::wpid_i, prm::wpid_d); }
+static void applyDAlpha()   { LineFollower_SetTurnDAlpha(prm::turn_d_alpha); }
+static void applyLoop()     { LineFollower_SetClosedLoop(prm::speed_loop); }
+static void applyImu()      { IMU_retuneFilter(); }
+
+// 关调度时把增益恢复成 lpid.* / fpid.*；开着时控制周期每次自己插值
+static void applyGainSched() {
+    applyTurnPid();
+    applyFwdPid();
+}
+
+static void applyWeights() {
+    int w[LineSensors::count];
+    for (size_t k = 0; k < LineSensors::count; k++) w[k] = (int)prm::line_w[k];
+    LineSensors::setWeights(w);
+}
+
+// ================== 参数表 ==================
+using param::Desc;
+using param::Type;
+using param::Persist;
+
+#define W_DEF(k) static_cast<float>(LineSensors::weights[k])
+
+//                 名字              类型         变量                         最小     最大    默认                   步长     标志     回调
+static constexpr std::array<Desc, 58> kParams = {{
+    {"lpid.p",        Type::Float, &prm::lpid_p,               0.0f,   10.0f,  0.1f,                  0.01f,   Persist, applyTurnPid},
+    {"lpid.i",        Type::Float, &prm::lpid_i,               0.0f,   10.0f,  0.0f,                  0.01f,   Persist, applyTurnPid},
+    {"lpid.d",        Type::Float, &prm::lpid_d,               0.0f,   10.0f,  0.2f,                  0.01f,   Persist, applyTurnPid},
+    {"fpid.p",        Type::Float, &prm::fpid_p,               0.0f,   10.0f,  1.0f,                  0.01f,   Persist, applyFwdPid},
+    {"fpid.i",        Type::Float, &prm::fpid_i,               0.0f,   10.0f,  0.0f,                  0.01f,   Persist, applyFwdPid},
+    {"fpid.d",        Type::Float, &prm::fpid_d,               0.0f,   10.0f,  0.0f,                  0.01f,   Persist, applyFwdPid},
+    {"wpid.p",        Type::Float, &prm::wpid_p,               0.0f,   10.0f,  0.5f,                  0.01f,   Persist, applyWheelPid},
+    {"wpid.i",        Type::Float, &prm::wpid_i,               0.0f,   1.0f,   0.005f,                0.001f,  Persist, applyWheelPid},
+    {"wpid.d",        Type::Float, &prm::wpid_d,               0.0f,   1.0f,   0.0f,                  0.001f,  Persist, applyWheelPid},
+    {"speed.straight",Type::Float, &prm::speed_straight,       0.0f,   1.0f,   0.10f,                 0.01f,   Persist, nullptr},
+    {"speed.arc",     Type::Float, &prm::speed_arc,            0.0f,   1.0f,   0.10f,                 0.01f,   Persist, nullptr},
+    {"turn.dalpha",   Type::Float, &prm::turn_d_alpha,         0.0f,   1.0f,   LF_TURN_D_ALPHA,       0.05f,   Persist, applyDAlpha},
+    {"speed.loop",    Type::Bool,  &prm::speed_loop,           0.0f,   1.0f,   LF_SPEED_LOOP_EN,      1.0f,    Persist, applyLoop},
+    {"line.w0",       Type::Int,   &prm::line_w[0],            -20.0f, 20.0f,  W_DEF(0),              1.0f,    Persist, applyWeights},
+    {"line.w1",       Type::Int,   &prm::line_w[1],            -20.0f, 20.0f,  W_DEF(1),              1.0f,    Persist, applyWeights},
+    {"line.w2",       Type::Int,   &prm::line_w[2],            -20.0f, 20.0f,  W_DEF(2),              1.0f,    Persist, applyWeights},
+    {"line.w3",       Type::Int,   &prm::line_w[3],            -20.0f, 20.0f,  W_DEF(3),              1.0f,    Persist, applyWeights},
+    {"line.w4",       Type::Int,   &prm::line_w[4],            -20.0f, 20.0f,  W_DEF(4),              1.0f,    Persist, applyWeights},
+    {"imu.kp",        Type::Float, &mahony_kp_settled,         0.0f,   20.0f,  MAHONY_KP_SETTLED,     0.05f,   Persist, applyImu},
+    {"imu.ki",        Type::Float, &mahony_ki,                 0.0f,   0.1f,   MAHONY_KI,             0.0005f, Persist, applyImu},
+    {"imu.beta",      Type::Float, &madgwick_beta_settled,     0.0f,   5.0f,   MADGWICK_BETA_SETTLED, 0.01f,   Persist, applyImu},
+    {"imu.mag_ok",    Type::Bool,  &mag_calibrated,            0.0f,   1.0f,   0.0f,                  1.0f,    Persist, nullptr},
+    {"imu.mag_ox",    Type::Float, &mag_offset[0],             -1000.0f, 1000.0f, IMU_MAG_OFFSET_X,   0.1f,    Persist, nullptr},
+    {"imu.mag_oy",    Type::Float, &mag_offset[1],             -1000.0f, 1000.0f, IMU_MAG_OFFSET_Y,   0.1f,    Persist, nullptr},
+    {"imu.mag_oz",    Type::Float, &mag_offset[2],             -1000.0f, 1000.0f, IMU_MAG_OFFSET_Z,   0.1f,    Persist, nullptr},
+    {"imu.mag_sx",    Type::Float, &mag_scale[0],              0.1f,   10.0f,  IMU_MAG_SCALE_X,       0.01f,   Persist, nullptr},
+    {"imu.mag_sy",    Type::Float, &mag_scale[1],              0.1f,   10.0f,  IMU_MAG_SCALE_Y,       0.01f,   Persist, nullptr},
+    {"imu.mag_sz",    Type::Float, &mag_scale[2],              0.1f,   10.0f,  IMU_MAG_SCALE_Z,       0.01f,   Persist, nullptr},
+    {"route.laps",    Type::Int,   &prm::route_laps,           1.0f,   20.0f,  1.0f,                  1.0f,    Persist, nullptr},
+    {"ilc.enable",    Type::Bool,  &prm::ilc_enable,           0.0f,   1.0f,   0.0f,                  1.0f,    Persist, nullptr},
+    {"ilc.err_line",  Type::Float, &prm::ilc_err_line,         0.0f,   10.0f,  3.0f,                  0.1f,    Persist, nullptr},
+    {"ilc.err_yaw",   Type::Float, &prm::ilc_err_yaw,          0.0f,   45.0f,  5.0f,                  0.5f,    Persist, nullptr},
+    {"ilc.sat",       Type::Float, &prm::ilc_sat_frac,         0.0f,   1.0f,   0.2f,                  0.05f,   Persist, nullptr},
+    {"ilc.step",      Type::Float, &prm::ilc_step,             0.0f,   0.2f,   0.02f,                 0.005f,  Persist, nullptr},
+    {"ilc.backoff",   Type::Float, &prm::ilc_backoff,          0.5f,   1.0f,   0.85f,                 0.01f,   Persist, nullptr},
+    {"ilc.vmin",      Type::Float, &prm::ilc_vmin,             0.0f,   1.0f,   0.08f,                 0.01f,   Persist, nullptr},
+    {"ilc.vmax",      Type::Float, &prm::ilc_vmax,             0.0f,   1.0f,   0.60f,                 0.01f,   Persist, nullptr},
+    {"gs.enable",     Type::Bool,  &prm::gs_enable,            0.0f,   1.0f,   0.0f,                  1.0f,    Persist, applyGainSched},
+    {"gs.v0",         Type::Float, &prm::gs_v[0],              0.0f,   1.0f,   0.10f,                 0.05f,   Persist, nullptr},
+    {"gs.v1",         Type::Float, &prm::gs_v[1],              0.0f,   1.0f,   0.30f,                 0.05f,   Persist, nullptr},
+    {"gs.v2",         Type::Float, &prm::gs_v[2],              0.0f,   1.0f,   0.60f,                 0.05f,   Persist, nullptr},
+    {"lpid1.p",       Type::Float, &prm::lpid_gs[0].kp,        -1.0f,  10.0f,  GS_INHERIT,            0.01f,   Persist, nullptr},
+    {"lpid1.i",       Type::Float, &prm::lpid_gs[0].ki,        -1.0f,  10.0f,  GS_INHERIT,            0.01f,   Persist, nullptr},
+    {"lpid1.d",       Type::Float, &prm::lpid_gs[0].kd,        -1.0f,  10.0f,  GS_INHERIT,            0.01f,   Persist, nullptr},
+    {"lpid2.p",       Type::Float, &prm::lpid_gs[1].kp,        -1.0f,  10.0f,  GS_INHERIT,            0.01f,   Persist, nullptr},
+    {"lpid2.i",       Type::Float, &prm::lpid_gs[1].ki,        -1.0f,  10.0f,  GS_INHERIT,            0.01f,   Persist, nullptr},
+    {"lpid2.d",       Type::Float, &prm::lpid_gs[1].kd,        -1.0f,  10.0f,  GS_INHERIT,            0.01f,   Persist, nullptr},
+    {"fpid1.p",       Type::Float, &prm::fpid_gs[0].kp,        -1.0f,  10.0f,  GS_INHERIT,            0.01f,   Persist, nullptr},
+    {"fpid1.i",       Type::Float, &prm::fpid_gs[0].ki,        -1.0f,  10.0f,  GS_INHERIT,            0.01f,   Persist, nullptr},
+    {"fpid1.d",       Type::Float, &prm::fpid_gs[0].kd,        -1.0f,  10.0f,  GS_INHERIT,            0.01f,   Persist, nullptr},
+    {"fpid2.p",       Type::Float, &prm::fpid_gs[1].kp,        -1.0f,  10.0f,  GS_INHERIT,            0.01f,   Persist, nullptr},
+    {"fpid2.i",       Type::Float, &prm::fpid_gs[1].ki,        -1.0f,  10.0f,  GS_INHERIT,            0.01f,   Persist, nullptr},
+    {"fpid2.d",       Type::Float, &prm::fpid_gs[1].kd,        -1.0f,  10.0f,  GS_INHERIT,            0.01f,   Persist, nullptr},
+    {"mp.enable",     Type::Bool,  &prm::mp_enable,            0.0f,   1.0f,   1.0f,                  1.0f,    Persist, nullptr},
+    {"mp.acc",        Type::Float, &prm::mp_acc,               0.1f,   10.0f,  2.0f,                  0.1f,    Persist, nullptr},
+    {"mp.jerk",       Type::Float, &prm::mp_jerk,              1.0f,   200.0f, 20.0f,                 1.0f,    Persist, nullptr},
+    {"mp.creep",      Type::Float, &prm::mp_creep,             0.0f,   0.5f,   0.05f,                 0.01f,   Persist, nullptr},
+    {"mp.turn_slew",  Type::Float, &prm::mp_turn_slew,         0.0f,   2.0f,   0.1f,                  0.01f,   Persist, nullptr},
+}};
+
+#undef W_DEF
+
+static constexpr size_t kSlots = param::tableSize(kParams.size());
+static constexpr param::PerfectHash<kSlots> kHash = param::buildPerfectHash<kSlots>(kParams);
+static_assert(kHash.seed != 0, "no collision-free seed found, enlarge tableSize()");
+
+// 变量有默认值之后才会有模块读它们，静态初始化阶段先写一遍 (不调回调，控制器还没建)
+[[maybe_unused]] static const bool s_defaults_loaded = (Param_resetDefaults(), true);
+
+// ================== 注册表接口 ==================
+int Param_count() {
+    return (int)kParams.size();
+}
+
+int Param_find(const char* name) {
+    uint8_t idx = kHash.lookup(name);
+    if (idx == 0xFF || std::strcmp(kParams[idx].name, name) != 0) return -1;
+    return idx;
+}
+
+int Param_findHash(uint32_t name_hash) {
+    for (size_t i = 0; i < kParams.size(); i++) {
+        if (param::hash(kParams[i].name, 0) == name_hash) return (int)i;
+    }
+    return -1;
+}
+
+const param::Desc& Param_desc(int idx) {
+    return kParams[idx];
+}
+
+float Param_get(int idx) {
+    if (idx < 0 || idx >= (int)kParams.size()) return 0.0f;
+    const Desc& d = kParams[idx];
+    switch (d.type) {
+        case Type::Int:  return (float)*static_cast<int32_t*>(d.ptr);
+        case Type::Bool: return *static_cast<bool*>(d.ptr) ? 1.0f : 0.0f;
+        default:         return *static_cast<float*>(d.ptr);
+    }
+}
+
+bool Param_set(int idx, float value, bool apply) {
+    if (idx < 0 || idx >= (int)kParams.size()) return false;
+    const Desc& d = kParams[idx];
+    if (!(value >= d.min)) value = d.min; // NaN 也落到下限
+    if (value > d.max) value = d.max;
+
+    // 单个 float / int32_t / bool 写入是原子的，中断里读到的要么是旧值要么是新值
+    switch (d.type) {
+        case Type::Int:  *static_cast<int32_t*>(d.ptr) = (int32_t)lroundf(value); break;
+        case Type::Bool: *static_cast<bool*>(d.ptr) = value != 0.0f; break;
+        default:         *static_cast<float*>(d.ptr) = value; break;
+    }
+    if (apply && d.apply) d.apply();
+    return true;
+}
+
+void Param_resetDefaults() {
+    for (size_t i = 0; i < kParams.size(); i++) Param_set((int)i, kParams[i].def, false);
+}
+
+void Param_applyAll() {
+    // 同一个回调只调一次 (PID 三项共用一个回调)
+    for (size_t i = 0; i < kParams.size(); i++) {
+        if (!kParams[i].apply) continue;
+        if (i > 0 && kParams[i - 1].apply == kParams[i].apply) continue;
+        kParams[i].apply();
+    }
+}
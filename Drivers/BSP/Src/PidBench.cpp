@@ -0,0 +1,81 @@
+#include "App_PidConfig.h"
+#include "PidFixed.hpp"
+#include "SEGGER_RTT.h"
+#include <cmath>
+
+// 串口 "BENCH" 触发：同一组输入分别跑 float / Q31 / Q15 PID，统计每次 compute 的周期数和输出偏差
+#define PID_BENCH_N  256U
+
+namespace {
+
+struct BenchInput {
+    float sp[PID_BENCH_N];
+    float meas[PID_BENCH_N];
+};
+
+BenchInput bench_in;
+float bench_ref[PID_BENCH_N];
+
+template <typename Fn>
+uint32_t timeLoop(Fn&& fn) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t t0 = DWT->CYCCNT;
+    for (uint32_t k = 0; k < PID_BENCH_N; k++) fn(k);
+    uint32_t cyc = DWT->CYCCNT - t0;
+    __set_PRIMASK(primask);
+    return cyc;
+}
+
+} // namespace
+
+void PidBench_Run(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    for (uint32_t k = 0; k < PID_BENCH_N; k++) {
+        bench_in.sp[k]   = 0.3f * sinf(0.010f * k);
+        bench_in.meas[k] = 0.25f * sinf(0.013f * k + 0.5f);
+    }
+
+    const float kp = 1.5f, ki = 0.01f, kd = 0.3f;
+    const float i_lim = 50.0f;   // 远大于 1：定点版本的积分累加量不能卡在 ±1.0
+
+    PidController<float> pf(kp, ki, kd, -1.0f, 1.0f);
+    pf.setIntegralLimit(i_lim);
+    uint32_t cyc_f = timeLoop([&](uint32_t k) {
+        bench_ref[k] = pf.compute(bench_in.sp[k], bench_in.meas[k]);
+    });
+
+    // 输入预先转换好，只计 compute 本身
+    static Q31 q31_sp[PID_BENCH_N], q31_meas[PID_BENCH_N], q31_out[PID_BENCH_N];
+    static Q15 q15_sp[PID_BENCH_N], q15_meas[PID_BENCH_N], q15_out[PID_BENCH_N];
+    for (uint32_t k = 0; k < PID_BENCH_N; k++) {
+        q31_sp[k] = Q31::fromFloat(bench_in.sp[k]);
+        q31_meas[k] = Q31::fromFloat(bench_in.meas[k]);
+        q15_sp[k] = Q15::fromFloat(bench_in.sp[k]);
+        q15_meas[k] = Q15::fromFloat(bench_in.meas[k]);
+    }
+
+    PidController<Q31> p31(kp, ki, kd, Q31::fromFloat(-1.0f), Q31::fromFloat(1.0f));
+    p31.setIntegralLimit(i_lim);
+    uint32_t cyc_31 = timeLoop([&](uint32_t k) {
+        q31_out[k] = p31.compute(q31_sp[k], q31_meas[k]);
+    });
+
+    PidController<Q15> p15(kp, ki, kd, Q15::fromFloat(-1.0f), Q15::fromFloat(1.0f));
+    p15.setIntegralLimit(i_lim);
+    uint32_t cyc_15 = timeLoop([&](uint32_t k) {
+        q15_out[k] = p15.compute(q15_sp[k], q15_meas[k]);
+    });
+
+    float err_31 = 0.0f, err_15 = 0.0f;
+    for (uint32_t k = 0; k < PID_BENCH_N; k++) {
+        err_31 = fmaxf(err_31, fabsf(q31_out[k].toFloat() - bench_ref[k]));
+        err_15 = fmaxf(err_15, fabsf(q15_out[k].toFloat() - bench_ref[k]));
+    }
+
+    RTT_Log("[Bench] PID x%u cycles/call: float=%u Q31=%u Q15=%u\r\n",
+            PID_BENCH_N, cyc_f / PID_BENCH_N, cyc_31 / PID_BENCH_N, cyc_15 / PID_BENCH_N);
+    RTT_Log("[Bench] max |diff| vs float: Q31=%f Q15=%f\r\n", err_31, err_15);
+}
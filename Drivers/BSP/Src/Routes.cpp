@@ -0,0 +1,174 @@
+#include "Route.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using route::Drive;
+using route::Trigger;
+using route::Prompt;
+using route::LockYaw;
+using route::ResetTurnPid;
+
+// ================== 内置路线 ==================
+// Q1: A -> B，到 B 停车并提示
+static constexpr RouteSegment kQ1[] = {
+    {Drive::YawHold,    Trigger::LineRise, LockYaw,                0, 0.0f},  // A -> B 直线
+    {Drive::Stop,       Trigger::End,      Prompt,                 0, 0.0f},  // B
+};
+
+// Q2: A -> B -> C -> D -> A，每过一点提示一次
+static constexpr RouteSegment kQ2[] = {
+    {Drive::YawHold,    Trigger::LineRise, Prompt | LockYaw,       0, 0.0f},  // A -> B 直线
+    {Drive::LineFollow, Trigger::LineFall, Prompt | ResetTurnPid,  0, 0.0f},  // B -> C 半圆
+    {Drive::YawHold,    Trigger::LineRise, Prompt | LockYaw,       0, 0.0f},  // C -> D 直线
+    {Drive::LineFollow, Trigger::LineFall, Prompt | ResetTurnPid,  0, 0.0f},  // D -> A 半圆
+    {Drive::Stop,       Trigger::End,      Prompt,                 0, 0.0f},  // 回到 A
+};
+
+static_assert(Route_valid(kQ1), "Q1 route malformed");
+static_assert(Route_valid(kQ2), "Q2 route malformed");
+
+// Q3/Q4 暂无内置路线，可用串口 ROUTESET 下发 (存 Flash)
+static constexpr Route kBuiltin[ROUTE_QUESTIONS] = {
+    {kQ1, sizeof(kQ1) / sizeof(kQ1[0])},
+    {kQ2, sizeof(kQ2) / sizeof(kQ2[0])},
+    {nullptr, 0},
+    {nullptr, 0},
+};
+
+// ================== 串口 / Flash 下发的路线 ==================
+static RouteSegment s_custom[ROUTE_QUESTIONS][ROUTE_MAX_SEG];
+static uint8_t s_custom_count[ROUTE_QUESTIONS];
+
+Route Route_get(uint8_t q) {
+    if (q < 1 || q > ROUTE_QUESTIONS) return {nullptr, 0};
+    if (s_custom_count[q - 1] > 0) return {s_custom[q - 1], s_custom_count[q - 1]};
+    return kBuiltin[q - 1];
+}
+
+bool Route_isCustom(uint8_t q) {
+    return q >= 1 && q <= ROUTE_QUESTIONS && s_custom_count[q - 1] > 0;
+}
+
+// 枚举值越界 (Flash 里的旧数据 / 坏数据) 或退出条件不对：整条路线作废
+static bool routeValid(const RouteSegment* seg, uint8_t n) {
+    if (n > ROUTE_MAX_SEG) return false;
+    for (uint8_t i = 0; i < n; i++) {
+        if ((uint8_t)seg[i].drive > (uint8_t)Drive::Stop || (uint8_t)seg[i].exit > (uint8_t)Trigger::Time) return false;
+        if ((seg[i].exit == Trigger::End) != (i + 1 == n)) return false;
+    }
+    return true;
+}
+
+// 调用方保证该题没在跑 (LineFollower 只在确认题号时取一次路线)
+bool Route_set(uint8_t q, const RouteSegment* seg, uint8_t n) {
+    if (q < 1 || q > ROUTE_QUESTIONS || !routeValid(seg, n)) return false;
+    std::memcpy(s_custom[q - 1], seg, n * sizeof(RouteSegment));
+    s_custom_count[q - 1] = n;
+    return true;
+}
+
+void Route_import(const RouteFlash& f) {
+    for (int q = 0; q < ROUTE_QUESTIONS; q++) {
+        uint8_t n = routeValid(f.seg[q], f.count[q]) ? f.count[q] : 0;
+        std::memcpy(s_custom[q], f.seg[q], sizeof(s_custom[q]));
+        s_custom_count[q] = n;
+    }
+}
+
+void Route_export(RouteFlash& f) {
+    std::memcpy(f.count, s_custom_count, sizeof(f.count));
+    std::memcpy(f.seg, s_custom, sizeof(f.seg));
+}
+
+// ================== 文本格式 ==================
+// 一段: <行驶>/<退出条件>[=参数][/<动作>]，段之间空格分隔
+//   行驶: Y 航向保持 / L 循线 / S 停车
+//   退出: RISE FALL DIST(m) HEAD(°) TIME(ms) END
+//   动作: P 提示 / Y 锁航向 / R 清循线 PID
+// 例 (内置 Q2): Y/RISE/PY L/FALL/PR Y/RISE/PY L/FALL/PR S/END/P
+static const char* const kTriggerNames[] = {"END", "RISE", "FALL", "DIST", "HEAD", "TIME"};
+static const char kDriveNames[] = "YLS";
+
+static bool parseSegment(char* tok, RouteSegment& s) {
+    s = {};
+    char* trig = std::strchr(tok, '/');
+    if (trig == nullptr || trig - tok != 1) return false;
+    *trig++ = '\0';
+
+    const char* d = std::strchr(kDriveNames, tok[0]);
+    if (tok[0] == '\0' || d == nullptr) return false;
+    s.drive = static_cast<Drive>(d - kDriveNames);
+
+    char* act = std::strchr(trig, '/');
+    if (act != nullptr) *act++ = '\0';
+    char* arg = std::strchr(trig, '=');
+    if (arg != nullptr) *arg++ = '\0';
+
+    bool found = false;
+    for (size_t k = 0; k < sizeof(kTriggerNames) / sizeof(kTriggerNames[0]); k++) {
+        if (std::strcmp(trig, kTriggerNames[k]) == 0) {
+            s.exit = static_cast<Trigger>(k);
+            found = true;
+        }
+    }
+    if (!found) return false;
+
+    bool needs_arg = s.exit == Trigger::Distance || s.exit == Trigger::Heading || s.exit == Trigger::Time;
+    if (needs_arg != (arg != nullptr)) return false;
+    if (arg != nullptr) {
+        char* end = nullptr;
+        s.arg = std::strtof(arg, &end);
+        if (end == arg || *end != '\0' || !(s.arg > 0.0f)) return false;
+    }
+
+    for (; act != nullptr && *act; act++) {
+        if (*act == 'P') s.actions |= Prompt;
+        else if (*act == 'Y') s.actions |= LockYaw;
+        else if (*act == 'R') s.actions |= ResetTurnPid;
+        else return false;
+    }
+    return true;
+}
+
+int Route_parse(const char* spec, RouteSegment* out, int max) {
+    char buf[160];
+    if (std::strlen(spec) >= sizeof(buf)) return -1;
+    std::strcpy(buf, spec);
+
+    int n = 0;
+    char* save = nullptr;
+    for (char* tok = strtok_r(buf, " ", &save); tok != nullptr; tok = strtok_r(nullptr, " ", &save)) {
+        if (n >= max || !parseSegment(tok, out[n])) return -1;
+        n++;
+    }
+    return (n > 0 && routeValid(out, (uint8_t)n)) ? n : -1;
+}
+
+int Route_format(uint8_t q, char* buf, size_t n) {
+    Route r = Route_get(q);
+    size_t len = 0;
+    buf[0] = '\0';
+    for (uint8_t i = 0; i < r.count && len < n; i++) {
+        const RouteSegment& s = r.seg[i];
+        char arg[16] = "";
+        if (s.exit == Trigger::Distance || s.exit == Trigger::Heading || s.exit == Trigger::Time) {
+            // newlib-nano 的 printf 不带浮点
+            uint32_t x = (uint32_t)lroundf(s.arg * 1000.0f);
+            snprintf(arg, sizeof(arg), "=%lu.%03lu", (unsigned long)(x / 1000), (unsigned long)(x % 1000));
+        }
+        char act[4] = "";
+        size_t a = 0;
+        if (s.actions & Prompt) act[a++] = 'P';
+        if (s.actions & LockYaw) act[a++] = 'Y';
+        if (s.actions & ResetTurnPid) act[a++] = 'R';
+        act[a] = '\0';
+
+        int w = snprintf(buf + len, n - len, "%s%c/%s%s%s%s", i ? " " : "",
+                         kDriveNames[(uint8_t)s.drive], kTriggerNames[(uint8_t)s.exit], arg, a ? "/" : "", act);
+        if (w < 0) break;
+        len += (size_t)w;
+    }
+    return len < n ? (int)len : (int)n - 1;
+}
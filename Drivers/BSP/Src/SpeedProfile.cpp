@@ -0,0 +1,114 @@
+#include "SpeedProfile.hpp"
+#include "SpeedLearner.hpp"
+#include "LapTimer_Interface.h"
+#include "Params.hpp"
+#include "W25Q64.hpp"
+#include "CrashLog.h"
+#include "App_PidConfig.h"
+#include "main.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "SEGGER_RTT.h"
+
+// 学到的速度放在路线表 (0x7FB000) 下面一个扇区
+#define ILC_FLASH_ADDR  0x7FA000
+#define ILC_MAGIC       0x31434C49U // "ILC1"
+
+extern W25Q64 w25q;                 // App_PidConfig.cpp
+
+float g_speed_profile[ROUTE_QUESTIONS][ROUTE_MAX_SEG];
+
+struct SpeedProfileFlash {
+    uint32_t magic;
+    uint32_t sum;                   // speed 逐字节累加和
+    float speed[ROUTE_QUESTIONS][ROUTE_MAX_SEG];
+};
+
+static uint32_t s_seen_seq = 0;
+static bool s_dirty = false;
+
+static uint32_t profile_sum(const SpeedProfileFlash& f) {
+    uint32_t sum = 0;
+    const uint8_t* p = (const uint8_t*)f.speed;
+    for (uint32_t i = 0; i < sizeof(f.speed); i++) sum += p[i];
+    return sum;
+}
+
+void SpeedProfile_Load(void) {
+    static SpeedProfileFlash f;
+    w25q.readData(ILC_FLASH_ADDR, (uint8_t*)&f, sizeof(f));
+    if (f.magic != ILC_MAGIC || f.sum != profile_sum(f)) return;
+    for (int q = 0; q < ROUTE_QUESTIONS; q++) {
+        for (int i = 0; i < ROUTE_MAX_SEG; i++) {
+            float v = f.speed[q][i];
+            g_speed_profile[q][i] = (v > 0.0f && v <= 1.0f) ? v : 0.0f;
+        }
+    }
+    RTT_Log("[ILC] speed profile loaded\r\n");
+}
+
+static void profile_save() {
+    static SpeedProfileFlash f;
+    f.magic = ILC_MAGIC;
+    std::memcpy(f.speed, g_speed_profile, sizeof(f.speed));
+    f.sum = profile_sum(f);
+
+    w25q.eraseSector(ILC_FLASH_ADDR);
+    const uint8_t* p = (const uint8_t*)&f;
+    for (uint32_t off = 0; off < sizeof(f); off += 256) {
+        uint32_t n = sizeof(f) - off;
+        w25q.writePage(ILC_FLASH_ADDR + off, (uint8_t*)p + off, n > 256 ? 256 : n);
+    }
+    CrashLog_Trace(TRACE_FLASH_SAVE, 3);
+}
+
+void SpeedProfile_Poll(void) {
+    static SegmentSplit splits[ROUTE_MAX_SEG];
+    uint8_t n, q;
+    bool aborted;
+    uint32_t seq = LapTimer_LastLap(splits, ROUTE_MAX_SEG, n, q, aborted);
+
+    if (seq != s_seen_seq) {
+        s_seen_seq = seq;
+        if (prm::ilc_enable && q >= 1 && q <= ROUTE_QUESTIONS) {
+            const LearnConfig c{prm::ilc_err_line, prm::ilc_err_yaw, prm::ilc_sat_frac,
+                                prm::ilc_step, prm::ilc_backoff, prm::ilc_vmin, prm::ilc_vmax};
+            // 控制中断读的是同一张表：单个 float 写入是原子的，逐段更新即可
+            int changed = SpeedLearner_update(g_speed_profile[q - 1], splits, n, aborted, c,
+                                              prm::speed_straight, prm::speed_arc);
+            if (changed) s_dirty = true;
+            RTT_Log("[ILC] Q%u lap%s: %d segments adjusted\r\n", q, aborted ? " (lost line)" : "", changed);
+        }
+    }
+
+    // 擦扇区要阻塞约 50ms，等车停下 (这一圈结束且没有下一圈) 再写
+    LapSummary sum;
+    uint32_t elapsed_ms;
+    LapTimer_Summary(q, sum, elapsed_ms);
+    if (s_dirty && elapsed_ms == 0) {
+        profile_save();
+        s_dirty = false;
+        RTT_Log("[ILC] speed profile saved\r\n");
+    }
+}
+
+void SpeedProfile_Clear(uint8_t q) {
+    if (q == 0) std::memset(g_speed_profile, 0, sizeof(g_speed_profile));
+    else if (q <= ROUTE_QUESTIONS) std::memset(g_speed_profile[q - 1], 0, sizeof(g_speed_profile[0]));
+    else return;
+    s_dirty = true;
+}
+
+// ILC Q<n> <段0> <段1> ...   占空比 x1000，0 = 用默认速度
+void SpeedProfile_Report(void) {
+    for (int q = 0; q < ROUTE_QUESTIONS; q++) {
+        char line[128];
+        int len = snprintf(line, sizeof(line), "ILC Q%d", q + 1);
+        for (int i = 0; i < ROUTE_MAX_SEG && len < (int)sizeof(line); i++) {
+            len += snprintf(line + len, sizeof(line) - len, " %ld", (long)lroundf(g_speed_profile[q][i] * 1000.0f));
+        }
+        App_Serial_Printf("%s\r\n", line);
+    }
+}
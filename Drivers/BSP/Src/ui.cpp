@@ -4,6 +4,11 @@
 #include "button.hpp"
 #include "u8g2.h"
 #include "OLED.h"     // drawFloatPrec()
+#include "IMU.h"
+#include "Params.hpp"
+#include "App_PidConfig.h"
+#include "LapTimer.hpp"
+#include "LapTimer_Interface.h"
 
 #include <cstdio>
 #include <cstring>
@@ -20,20 +25,64 @@ static Button btnUp(Button2_GPIO_Port, Button2_Pin, true);
 static Button btnDown(Button1_GPIO_Port, Button1_Pin, true);
 static Button btnOk(Button3_GPIO_Port, Button3_Pin, true);
 
+// 参数页：长按 OK 进出；Up/Down 选参数，OK 切换编辑，编辑时 Up/Down 按步长加减
+static bool g_param_page = false;
+static bool g_param_edit = false;
+static bool g_param_dirty = false;
+static int  g_param_sel = 0;
+
+static void paramStep(int dir) {
+    const param::Desc& d = Param_desc(g_param_sel);
+    Param_set(g_param_sel, Param_get(g_param_sel) + dir * d.step);
+    g_param_dirty = true;
+}
+
+// 圈速页：长按 Up 进出，显示当前确认题的计时
+static bool g_lap_page = false;
+
+static void onUpLongPress() {
+    if (!g_param_page) g_lap_page = !g_lap_page;
+}
+
 static void onUpClick() {
+    if (g_param_page) {
+        if (g_param_edit) paramStep(+1);
+        else g_param_sel = (g_param_sel <= 0) ? Param_count() - 1 : g_param_sel - 1;
+        return;
+    }
     g_selected_q = (g_selected_q <= 1) ? 4 : static_cast<uint8_t>(g_selected_q - 1);
 }
 static void onDownClick() {
+    if (g_param_page) {
+        if (g_param_edit) paramStep(-1);
+        else g_param_sel = (g_param_sel >= Param_count() - 1) ? 0 : g_param_sel + 1;
+        return;
+    }
     g_selected_q = (g_selected_q >= 4) ? 1 : static_cast<uint8_t>(g_selected_q + 1);
 }
 static void onOkClick() {
+    if (g_param_page) {
+        g_param_edit = !g_param_edit;
+        return;
+    }
     g_confirmed_q = g_selected_q;
 }
+static void onOkLongPress() {
+    g_lap_page = false;
+    if (g_param_page && g_param_dirty) {
+        App_Pid_Save(); // 退出参数页时改过才写 Flash (阻塞约 50ms)
+        g_param_dirty = false;
+    }
+    g_param_page = !g_param_page;
+    g_param_edit = false;
+}
 
 void UI_Init(void) {
     btnUp.attachClick(onUpClick);
+    btnUp.attachLongPress(onUpLongPress);
     btnDown.attachClick(onDownClick);
     btnOk.attachClick(onOkClick);
+    btnOk.attachLongPress(onOkLongPress);
 }
 
 void UI_Button_Update(void) {
@@ -117,14 +166,85 @@ static void draw_ypr_table(float yaw, float pitch, float roll) {
     drawFloatPrec(&u8g2, 40, y3, roll,  2);
 }
 
+static void draw_param_page(void) {
+    // 标题栏：参数序号
+    u8g2_SetDrawColor(&u8g2, 1);
+    u8g2_DrawBox(&u8g2, 0, 0, 128, 12);
+    u8g2_SetDrawColor(&u8g2, 0);
+    u8g2_DrawStr(&u8g2, 2, 10, g_param_edit ? "Param EDIT" : "Params");
+    char buf[12];
+    snprintf(buf, sizeof(buf), "%d/%d", g_param_sel + 1, Param_count());
+    u8g2_DrawStr(&u8g2, (u8g2_uint_t)(126 - 6 * (int)strlen(buf)), 10, buf);
+    u8g2_SetDrawColor(&u8g2, 1);
+
+    // 4 行窗口跟着选中项滚动；选中行反显，编辑中在行首加 '>'
+    constexpr int rows = 4;
+    int first = g_param_sel - 1;
+    if (first > Param_count() - rows) first = Param_count() - rows;
+    if (first < 0) first = 0;
+
+    for (int r = 0; r < rows && first + r < Param_count(); r++) {
+        int idx = first + r;
+        auto y = static_cast<uint8_t>(24 + r * 12);
+        const param::Desc& d = Param_desc(idx);
+
+        if (idx == g_param_sel) {
+            u8g2_DrawBox(&u8g2, 0, y - 10, 128, 12);
+            u8g2_SetDrawColor(&u8g2, 0);
+        }
+        u8g2_DrawStr(&u8g2, 0, y, (idx == g_param_sel && g_param_edit) ? ">" : " ");
+        u8g2_DrawStr(&u8g2, 6, y, d.name);
+        uint8_t prec = d.type == param::Type::Float ? (d.step < 0.01f ? 4 : 2) : 0;
+        drawFloatPrec(&u8g2, 90, y, Param_get(idx), prec);
+        u8g2_SetDrawColor(&u8g2, 1);
+    }
+}
+
+static void draw_lap_page(void) {
+    uint8_t q = g_confirmed_q ? g_confirmed_q : g_selected_q;
+    LapSummary sum;
+    uint32_t now_ms;
+    LapTimer_Summary(q, sum, now_ms);
+
+    u8g2_SetDrawColor(&u8g2, 1);
+    u8g2_DrawBox(&u8g2, 0, 0, 128, 12);
+    u8g2_SetDrawColor(&u8g2, 0);
+    char buf[20];
+    snprintf(buf, sizeof(buf), "Lap Q%u", (unsigned)q);
+    u8g2_DrawStr(&u8g2, 2, 10, buf);
+    snprintf(buf, sizeof(buf), "n=%lu", (unsigned long)sum.laps);
+    u8g2_DrawStr(&u8g2, (u8g2_uint_t)(126 - 6 * (int)strlen(buf)), 10, buf);
+    u8g2_SetDrawColor(&u8g2, 1);
+
+    // 秒，两位小数；没有数据显示 "-"
+    const char* labels[4] = {"Now:", "Last:", "Best:", "Mean:"};
+    uint32_t vals[4] = {now_ms, sum.last_ms, sum.best_ms, sum.laps ? sum.total_ms / sum.laps : 0};
+    for (int r = 0; r < 4; r++) {
+        auto y = static_cast<uint8_t>(24 + r * 12);
+        u8g2_DrawStr(&u8g2, 0, y, labels[r]);
+        if (vals[r] == 0) u8g2_DrawStr(&u8g2, 48, y, "-");
+        else drawFloatPrec(&u8g2, 48, y, vals[r] / 1000.0f, 2);
+    }
+}
+
 void UI_Render(void) {
     // 本地拷贝一次，减少中断更新撕裂
     float yaw = User_YPR[0];
-    float pit = User_YPR[1];
-    float rol = User_YPR[2];
+    // 俯仰/横滚只在显示时算 (IMU_LAZY_PITCH_ROLL)
+    float pr[2];
+    IMU_getPitchRoll(pr);
+    float pit = pr[0];
+    float rol = pr[1];
 
     u8g2_ClearBuffer(&u8g2);
 
+    if (g_param_page || g_lap_page) {
+        if (g_param_page) draw_param_page();
+        else draw_lap_page();
+        u8g2_SendBuffer(&u8g2);
+        return;
+    }
+
     draw_top_bar();
     draw_question_selector();
     draw_ypr_table(yaw, pit, rol);
@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""
+经 USART3 导出 W25Q64 里的黑匣子日志，存成 CSV
+
+用法: python3 blackbox_dump.py /dev/ttyUSB0 [out.csv]
+依赖: pyserial
+"""
+import struct
+import sys
+
+import serial
+
+SAMPLE = struct.Struct("<IHBBBBhhhhhfhhhH")  # 与 BlackBox.hpp 的 BlackBoxSample 一致 (32 字节)
+FIELDS = ["t_ms", "sensor", "question", "state", "mode", "flags",
+          "duty_l", "duty_r", "speed_l", "speed_r", "gyro_z", "yaw",
+          "pid_p", "pid_i", "pid_d", "seq"]
+NORMAL_BAUD = 115200
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        return 1
+    port = sys.argv[1]
+    out = sys.argv[2] if len(sys.argv) > 2 else "blackbox.csv"
+
+    ser = serial.Serial(port, NORMAL_BAUD, timeout=5)
+    ser.reset_input_buffer()
+    ser.write(b"BBDUMP\r\n")
+
+    # 等 "BBDUMP n=.. size=.. baud=.." 那一行 (前面可能混着别的输出)
+    while True:
+        line = ser.readline().decode(errors="ignore").strip()
+        if not line:
+            print("no response")
+            return 1
+        if line.startswith("BBDUMP"):
+            break
+    kv = dict(item.split("=") for item in line.split()[1:])
+    n, size, baud = int(kv["n"]), int(kv["size"]), int(kv["baud"])
+    if size != SAMPLE.size:
+        print("sample size mismatch: %d != %d" % (size, SAMPLE.size))
+        return 1
+    if n == 0:
+        print("log is empty")
+        return 0
+
+    ser.baudrate = baud
+    raw = ser.read(n * size + 4)
+    ser.baudrate = NORMAL_BAUD
+    if len(raw) != n * size + 4:
+        print("short read: %d / %d bytes" % (len(raw), n * size + 4))
+        return 1
+
+    data, (checksum,) = raw[:-4], struct.unpack("<I", raw[-4:])
+    if sum(data) & 0xFFFFFFFF != checksum:
+        print("checksum mismatch")
+        return 1
+
+    lost = 0
+    prev = None
+    with open(out, "w") as f:
+        f.write(",".join(FIELDS) + "\n")
+        for i in range(n):
+            s = SAMPLE.unpack_from(data, i * size)
+            if prev is not None:
+                lost += (s[-1] - prev - 1) & 0xFFFF
+            prev = s[-1]
+            row = list(s)
+            for k in (6, 7, 12, 13, 14):      # x10000 定点
+                row[k] = "%.4f" % (row[k] / 10000.0)
+            row[10] = "%.2f" % (row[10] / 100.0)  # 0.01 °/s
+            row[11] = "%.3f" % row[11]
+            f.write(",".join(str(v) for v in row) + "\n")
+
+    print("%d samples -> %s (seq gaps: %d)" % (n, out, lost))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
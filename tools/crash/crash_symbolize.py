@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""
+解析 "CRASH" 命令导出的崩溃现场，用 ELF 把地址翻译成函数名 / 源码行
+
+用法:
+  python3 crash_symbolize.py BasicCar.elf /dev/ttyUSB0    # 直接发 CRASH 并接收
+  python3 crash_symbolize.py BasicCar.elf crash.txt       # 解析保存下来的串口输出
+依赖: arm-none-eabi-addr2line (可用 --addr2line 指定)；串口方式需要 pyserial
+"""
+import argparse
+import os
+import subprocess
+import sys
+
+CODE_BEGIN, CODE_END = 0x08000000, 0x08020000  # 内部 Flash 128K (链接脚本 FLASH)
+
+CFSR_BITS = {
+    0: "IACCVIOL 取指违反 MPU", 1: "DACCVIOL 数据访问违反 MPU", 3: "MUNSTKERR 出栈 MemManage",
+    4: "MSTKERR 入栈 MemManage", 5: "MLSPERR 浮点惰性保存 MemManage", 7: "MMARVALID",
+    8: "IBUSERR 取指总线错误", 9: "PRECISERR 精确数据总线错误", 10: "IMPRECISERR 非精确数据总线错误",
+    11: "UNSTKERR 出栈总线错误", 12: "STKERR 入栈总线错误 (栈溢出?)", 13: "LSPERR 浮点惰性保存总线错误",
+    15: "BFARVALID",
+    16: "UNDEFINSTR 未定义指令", 17: "INVSTATE 非法状态 (跳到偶地址?)", 18: "INVPC 非法 EXC_RETURN",
+    19: "NOCP 协处理器未使能", 24: "UNALIGNED 非对齐访问", 25: "DIVBYZERO 除零",
+}
+HFSR_BITS = {1: "VECTTBL 取向量失败", 30: "FORCED 由可配置故障升级", 31: "DEBUGEVT"}
+TRACE_NAMES = {1: "BOOT", 2: "QUESTION", 3: "WAYPOINT", 4: "CMD", 5: "FLASH_SAVE", 6: "BLACKBOX"}
+FLASH_SAVE_NAMES = {0: "PID", 1: "gyro bias", 2: "routes", 3: "ILC speed profile"}
+
+
+def read_serial(port):
+    import serial
+    ser = serial.Serial(port, 115200, timeout=3)
+    ser.reset_input_buffer()
+    ser.write(b"CRASH\r\n")
+    lines = []
+    while True:
+        line = ser.readline().decode(errors="ignore").strip()
+        if not line:
+            break
+        lines.append(line)
+        if line == "CRASHEND":
+            break
+    return lines
+
+
+def parse(lines):
+    rec = {"stack": [], "trace": []}
+    started = False
+    for line in lines:
+        parts = line.split()
+        if not parts:
+            continue
+        tag = parts[0]
+        if tag == "CRASH":
+            started = True
+            if len(parts) > 1 and parts[1] == "none":
+                return None
+        if not started:
+            continue
+        if tag in ("CRASH", "REG", "FAULT"):
+            for kv in parts[1:]:
+                k, v = kv.split("=")
+                rec[k] = v if k == "type" else int(v, 0)
+        elif tag == "STACK":
+            base = int(parts[1], 16)
+            for i, w in enumerate(parts[2:]):
+                rec["stack"].append((base + i * 4, int(w, 16)))
+        elif tag == "TRACE":
+            rec["trace"].append(tuple(int(x) for x in parts[1:4]))
+        elif tag == "CRASHEND":
+            break
+    return rec if started else None
+
+
+def symbolize(addr2line, elf, addrs):
+    if not addrs:
+        return {}
+    args = [addr2line, "-e", elf, "-f", "-C", "-p"] + ["0x%08x" % (a & ~1) for a in addrs]
+    try:
+        out = subprocess.run(args, capture_output=True, text=True, check=True).stdout.splitlines()
+    except (OSError, subprocess.CalledProcessError) as e:
+        print("addr2line failed: %s" % e)
+        return {}
+    return dict(zip(addrs, out))
+
+
+def bits(value, table):
+    return ", ".join(name for bit, name in sorted(table.items()) if value & (1 << bit)) or "-"
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("elf")
+    ap.add_argument("source", help="串口设备或保存的文本")
+    ap.add_argument("--addr2line", default="arm-none-eabi-addr2line")
+    a = ap.parse_args()
+
+    if os.path.isfile(a.source):
+        with open(a.source, errors="ignore") as f:
+            lines = [l.strip() for l in f]
+    else:
+        lines = read_serial(a.source)
+
+    rec = parse(lines)
+    if rec is None:
+        print("no crash record")
+        return 0
+
+    # PC / LR + 栈里像返回地址的字 (落在代码区且 Thumb 位为 1)
+    cands = [w for _, w in rec["stack"] if CODE_BEGIN <= w < CODE_END and (w & 1)]
+    addrs = sorted(set([rec.get("pc", 0), rec.get("lr", 0)] + cands))
+    sym = symbolize(a.addr2line, a.elf, [x for x in addrs if CODE_BEGIN <= x < CODE_END])
+
+    print("type  : %s  (t=%d ms, EXC_RETURN=0x%08x)" % (rec.get("type"), rec.get("t_ms", 0), rec.get("exc_return", 0)))
+    for k in ("pc", "lr"):
+        v = rec.get(k, 0)
+        print("%-6s: 0x%08x  %s" % (k.upper(), v, sym.get(v, "?")))
+    print("SP    : 0x%08x  xPSR=0x%08x" % (rec.get("sp", 0), rec.get("xpsr", 0)))
+    print("R0-R3 : 0x%08x 0x%08x 0x%08x 0x%08x  R12=0x%08x" %
+          tuple(rec.get(k, 0) for k in ("r0", "r1", "r2", "r3", "r12")))
+    cfsr, hfsr = rec.get("cfsr", 0), rec.get("hfsr", 0)
+    print("CFSR  : 0x%08x  %s" % (cfsr, bits(cfsr, CFSR_BITS)))
+    print("HFSR  : 0x%08x  %s" % (hfsr, bits(hfsr, HFSR_BITS)))
+    if cfsr & (1 << 7):
+        print("MMFAR : 0x%08x" % rec.get("mmfar", 0))
+    if cfsr & (1 << 15):
+        print("BFAR  : 0x%08x" % rec.get("bfar", 0))
+
+    print("\n栈里的候选返回地址 (由近到远):")
+    for addr, w in rec["stack"]:
+        if w in cands:
+            print("  [0x%08x] 0x%08x  %s" % (addr, w, sym.get(w, "?")))
+
+    print("\n最近事件 (旧 -> 新):")
+    for t, i, arg in rec["trace"]:
+        name = TRACE_NAMES.get(i, str(i))
+        if name == "CMD":
+            arg_s = repr(bytes([arg >> 8, arg & 0xFF]).decode(errors="replace"))
+        elif name == "WAYPOINT":
+            arg_s = "q%d seg %d" % (arg >> 8, arg & 0xFF)
+        elif name == "FLASH_SAVE":
+            arg_s = FLASH_SAVE_NAMES.get(arg, str(arg))
+        else:
+            arg_s = "0x%04x" % arg
+        print("  %8d ms  %-10s %s" % (t, name, arg_s))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,142 @@
+/*
+ * EncoderVelocity 主机测试 (Linux 主机)
+ *
+ * 用一个理想轮子生成 A 相边沿：轮面位置按给定速度曲线以 1 µs 步长积分，
+ * 每越过一个计数边界就更新 TIM 计数器并按固件的方式调用 onEdge(DWT 时间)；
+ * 每 1 ms 调一次 sample() (与 TIM17 内环同频)，把估计值和真实速度比对。
+ *
+ * 覆盖：
+ *   高速   1 m/s，16 位计数器 (右轮 TIM3) 从 0xFFF0 起回绕，同时 DWT->CYCCNT 回绕
+ *   低速   0.02 m/s (每 13 ms 一个边沿)，32 位计数器 (左轮 TIM2) 回绕，镜像安装 dir = -1
+ *   停转   0.3 m/s 突然停住，估计值只降不升，EV_STALL_MS 后归零
+ *   换向   0.3 -> -0.3 m/s 匀减速过零，过零点正好擦过一个计数边界 (来回各出一个边沿)
+ *   抖动   静止时在一个计数边界上来回抖 (±0.6 计数，5 Hz)
+ *
+ * 用法: encoder_vel [-v]
+ *   -v  每个用例逐毫秒打印 t, 真实速度, 估计值
+ * 返回 0 = 全部通过，1 = 有用例不通过
+ */
+#include "EncoderVelocity.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+
+DWT_Type host_dwt;
+uint32_t SystemCoreClock = 480000000U;
+
+#define SIM_CYC_PER_US  480U
+
+static bool verbose = false;
+
+struct Case {
+    const char* name;
+    std::function<double(double)> v;   // t (s) -> 轮面速度 (m/s，前进为正)
+    double   t_end;                     // s
+    uint32_t arr;                       // 计数器自动重装值 (16 / 32 位)
+    uint32_t cnt0;                      // 计数器初值
+    int8_t   dir;                       // 前进时计数方向
+    double   pos0;                      // 初始位置 (计数，带小数)
+    uint32_t cyc0;                      // DWT 初值
+    // 每个采样点的检查：t, 真实速度, 估计值；返回 false 记一次失败
+    std::function<bool(double, double, float)> check;
+};
+
+static bool run(const Case& c) {
+    TIM_TypeDef tim{};
+    tim.ARR = c.arr;
+    TIM_HandleTypeDef htim{&tim};
+    const uint32_t mask = (c.arr <= 0xFFFFU) ? 0xFFFFU : 0xFFFFFFFFU;
+
+    double pos = c.pos0;
+    const long long k0 = (long long)std::floor(pos);
+    long long k_last = k0;
+    tim.CNT = c.cnt0;
+    host_dwt.CYCCNT = c.cyc0;
+
+    EncoderVelocity ev(&htim, c.dir, ENC_LEFT_A);
+    ev.reset();
+
+    int fails = 0;
+    const long total_us = (long)(c.t_end * 1e6);
+    for (long us = 1; us <= total_us; us++) {
+        double t = us * 1e-6;
+        host_dwt.CYCCNT = c.cyc0 + (uint32_t)us * SIM_CYC_PER_US;
+
+        pos += c.v(t) * 1e-6 / (double)ODOM_M_PER_COUNT;
+        long long k = (long long)std::floor(pos);
+        if (k != k_last) {
+            k_last = k;
+            tim.CNT = (c.cnt0 + (uint32_t)(c.dir * (k - k0))) & mask;
+            ev.onEdge(host_dwt.CYCCNT);
+        }
+
+        if (us % 1000 == 0) {
+            double v = c.v(t);
+            float est = ev.sample(host_dwt.CYCCNT);
+            if (verbose) printf("%s,%.3f,%.5f,%.5f\n", c.name, t, v, est);
+            if (!c.check(t, v, est)) {
+                if (fails < 5) fprintf(stderr, "  %s: t=%.3f s v=%.5f est=%.5f\n", c.name, t, v, est);
+                fails++;
+            }
+        }
+    }
+    printf("%-6s %s  (%d 个采样不通过)\n", c.name, fails ? "FAIL" : "ok  ", fails);
+    return fails == 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "-v") == 0) verbose = true;
+
+    const double M = ODOM_M_PER_COUNT;
+    const double stall = EV_STALL_MS * 1e-3;
+    bool ok = true;
+
+    // 高速：每个采样周期 3~4 个边沿，估计值应等于真实速度 (只差 DWT 取整)
+    ok &= run({"高速", [](double) { return 1.0; }, 0.2, 0xFFFFU, 0xFFF0U, 1, 0.5,
+               0xFFFFFFFFU - 50U * 480000U,
+               [](double t, double v, float e) { return t < 0.005 || std::fabs(e - v) <= 0.01 * v; }});
+
+    // 低速：T 法，两个边沿之后每个采样都应准 (两沿之间的上界压缩不会压到真实速度以下)
+    ok &= run({"低速", [](double) { return 0.02; }, 0.5, 0xFFFFFFFFU, 0xFFFFFFF8U, -1, 0.5, 0,
+               [](double t, double v, float e) { return t < 0.05 || std::fabs(e - v) <= 0.01 * v; }});
+
+    // 停转：停下之后估计值不回升，EV_STALL_MS (+ 一个边沿周期的余量) 后为 0
+    {
+        float last = 1e9f;
+        ok &= run({"停转", [](double t) { return t < 0.2 ? 0.3 : 0.0; }, 0.5, 0xFFFFU, 0, 1, 0.5, 0,
+                   [&](double t, double v, float e) {
+                       if (t < 0.2) return t < 0.01 || std::fabs(e - v) <= 0.01 * 0.3;
+                       bool r = e >= 0.0f && e <= last;
+                       last = e;
+                       if (t > 0.2 + stall + 0.002) r = r && e == 0.0f;
+                       return r;
+                   }});
+    }
+
+    // 换向：匀减速过零。过零前后的边沿间隔里轮子折返，净位移为 0 但计数差 -1，
+    // 估计值不能跳成反向大速度；离零点较远时符号和大小都要跟上 (减速时 T 法滞后半个边沿周期)
+    {
+        const double a = 0.6;
+        const double peak = 0.3 * 0.3 / (2.0 * a) / M;      // 过零前走过的计数
+        const double pos0 = 288.0 + 0.001 - peak;           // 折返点只越过边界 0.001 个计数
+        ok &= run({"换向", [a](double t) { return t < 1.0 ? 0.3 - a * t : -0.3; }, 1.3, 0xFFFFU, 100, 1, pos0, 0,
+                   [](double t, double v, float e) {
+                       if (t < 0.01) return true;
+                       if (std::fabs(e) > 0.3 * 1.01) return false;
+                       if (std::fabs(v) >= 0.05 && (e > 0.0f) != (v > 0.0)) return false;
+                       return std::fabs(e - v) <= 0.02;
+                   }});
+    }
+
+    // 抖动：静止时在计数边界上来回 (±0.6 计数)，计数一直 +1/-1 交替，每段都是换向，估计值应为 0
+    {
+        const double w = 2.0 * M_PI * 5.0;
+        ok &= run({"抖动", [M, w](double t) { return 0.6 * M * w * std::cos(w * t); }, 1.0, 0xFFFFU, 0, 1, 10.0, 0,
+                   [](double, double, float e) { return e == 0.0f; }});
+    }
+
+    printf("%s\n", ok ? "OK" : "FAIL");
+    return ok ? 0 : 1;
+}
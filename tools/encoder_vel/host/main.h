@@ -0,0 +1,53 @@
+#ifndef __MAIN_H
+#define __MAIN_H
+
+/* 主机测试用的 main.h 替身：只提供 EncoderVelocity.hpp / Odometry.hpp 用到的 HAL / CMSIS 符号 */
+#include <stdint.h>
+
+typedef struct {
+    volatile uint32_t CNT;
+    volatile uint32_t ARR;
+} TIM_TypeDef;
+
+typedef struct {
+    TIM_TypeDef* Instance;
+} TIM_HandleTypeDef;
+
+#define __HAL_TIM_GET_COUNTER(h)     ((h)->Instance->CNT)
+#define __HAL_TIM_GET_AUTORELOAD(h)  ((h)->Instance->ARR)
+#define TIM_CHANNEL_ALL              0x3CU
+static inline int HAL_TIM_Encoder_Start(TIM_HandleTypeDef* h, uint32_t ch) { (void)h; (void)ch; return 0; }
+
+typedef struct {
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+extern DWT_Type host_dwt;
+extern uint32_t SystemCoreClock;
+#define DWT  (&host_dwt)
+
+static inline void __DMB(void) {}
+
+typedef enum { EXTI0_IRQn = 6, EXTI9_5_IRQn = 23 } IRQn_Type;
+
+#define GPIO_PIN_0   ((uint16_t)0x0001)
+#define GPIO_PIN_6   ((uint16_t)0x0040)
+#define EXTI_LINE_0  0x00U
+#define EXTI_LINE_6  0x06U
+#define EXTI_GPIOA   0x00U
+#define EXTI_GPIOC   0x02U
+
+typedef struct { uint32_t Line; } EXTI_HandleTypeDef;
+typedef struct {
+    uint32_t Line, Mode, Trigger, GPIOSel, PendClearSource;
+} EXTI_ConfigTypeDef;
+
+#define EXTI_MODE_INTERRUPT          0x01U
+#define EXTI_TRIGGER_RISING_FALLING  0x03U
+#define EXTI_D3_PENDCLR_SRC_NONE     0x00U
+#define __HAL_RCC_SYSCFG_CLK_ENABLE() do {} while (0)
+static inline int HAL_EXTI_SetConfigLine(EXTI_HandleTypeDef* h, EXTI_ConfigTypeDef* c) { (void)h; (void)c; return 0; }
+static inline void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t p, uint32_t s) { (void)irq; (void)p; (void)s; }
+static inline void HAL_NVIC_EnableIRQ(IRQn_Type irq) { (void)irq; }
+
+#endif
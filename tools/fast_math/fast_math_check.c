@@ -0,0 +1,105 @@
+/*
+ * 快速反三角函数主机测试 (Linux 主机)
+ *
+ * 对照 libm 双精度 atan2 / asin 扫描 fast_math.h：
+ *   fast_atan2f  单位圆上 2^20 个方向 x 多个半径 (1e-30 ~ 1e30，含单精度舍入)，加坐标轴、对角线和原点
+ *   fast_asinf   [-1, 1] 上 2^20 个等分点，加 ±1 附近逐个 float 和 |x| > 1 的钳位
+ * 检查最大误差不超过文件头写的 1.2e-5 rad (0.00067°)，即 README 里的 "< 0.001°"。
+ *
+ * 用法: fast_math_check
+ * 返回 0 = 误差在文档范围内，1 = 超差
+ */
+#include "fast_math.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+
+#define FM_MAX_ERR_RAD  1.2e-5      /* fast_math.h 文件头 */
+#define FM_MAX_ERR_DEG  0.001       /* README */
+#define FM_SWEEP_N      (1 << 20)
+
+#define RAD2DEG  (180.0 / M_PI)
+
+typedef struct {
+    double worst;
+    float  at_a, at_b;
+} ErrStat;
+
+static void track(ErrStat* s, double err, float a, float b)
+{
+    if (err > s->worst) {
+        s->worst = err;
+        s->at_a = a;
+        s->at_b = b;
+    }
+}
+
+static void atan2_at(ErrStat* s, float y, float x)
+{
+    double ref = atan2((double)y, (double)x);
+    double err = fabs((double)fast_atan2f(y, x) - ref);
+    /* ±π 分界上 -0 / +0 取哪边都对 */
+    if (err > M_PI) err = fabs(err - 2.0 * M_PI);
+    track(s, err, y, x);
+}
+
+static int report(const char* name, const ErrStat* s)
+{
+    int ok = s->worst <= FM_MAX_ERR_RAD && s->worst * RAD2DEG < FM_MAX_ERR_DEG;
+    printf("%-12s %s  max err %.3e rad = %.5f deg  (at %g, %g)\n",
+           name, ok ? "ok  " : "FAIL", s->worst, s->worst * RAD2DEG, s->at_a, s->at_b);
+    return ok;
+}
+
+int main(void)
+{
+    static const float radius[] = {1e-30f, 1e-6f, 1e-3f, 1.0f, 9.81f, 1e3f, 1e6f, 1e30f};
+    ErrStat st_atan = {0}, st_asin = {0};
+    int ok = 1;
+
+    /* ---- fast_atan2f ---- */
+    for (unsigned r = 0; r < sizeof(radius) / sizeof(radius[0]); r++) {
+        for (int i = 0; i < FM_SWEEP_N; i++) {
+            double th = -M_PI + 2.0 * M_PI * (i + 0.5) / FM_SWEEP_N;
+            atan2_at(&st_atan, (float)(radius[r] * sin(th)), (float)(radius[r] * cos(th)));
+        }
+        /* 坐标轴和对角线 (象限归约的分界) */
+        for (int q = 0; q < 8; q++) {
+            double th = -M_PI + M_PI / 4.0 * q;
+            atan2_at(&st_atan, (float)(radius[r] * sin(th)), (float)(radius[r] * cos(th)));
+        }
+        atan2_at(&st_atan, radius[r], 0.0f);
+        atan2_at(&st_atan, -radius[r], 0.0f);
+        atan2_at(&st_atan, 0.0f, radius[r]);
+        atan2_at(&st_atan, 0.0f, -radius[r]);
+        atan2_at(&st_atan, radius[r], radius[r]);
+        atan2_at(&st_atan, -radius[r], -radius[r]);
+    }
+    if (fast_atan2f(0.0f, 0.0f) != 0.0f) {
+        printf("fast_atan2f(0, 0) != 0\n");
+        ok = 0;
+    }
+    ok &= report("fast_atan2f", &st_atan);
+
+    /* ---- fast_asinf ---- */
+    for (int i = 0; i <= FM_SWEEP_N; i++) {
+        float x = (float)(-1.0 + 2.0 * i / FM_SWEEP_N);
+        track(&st_asin, fabs((double)fast_asinf(x) - asin((double)x)), x, 0.0f);
+    }
+    /* ±1 附近 sqrt(1 - x^2) 最敏感：逐个 float 往里走 */
+    float x = 1.0f;
+    for (int i = 0; i < 4096; i++) {
+        track(&st_asin, fabs((double)fast_asinf(x) - asin((double)x)), x, 0.0f);
+        track(&st_asin, fabs((double)fast_asinf(-x) - asin((double)-x)), -x, 0.0f);
+        x = nextafterf(x, 0.0f);
+    }
+    /* |x| > 1 钳位到 ±π/2 */
+    track(&st_asin, fabs((double)fast_asinf(1.5f) - M_PI_2), 1.5f, 0.0f);
+    track(&st_asin, fabs((double)fast_asinf(-1.5f) + M_PI_2), -1.5f, 0.0f);
+    track(&st_asin, fabs((double)fast_asinf(nextafterf(1.0f, 2.0f)) - M_PI_2), nextafterf(1.0f, 2.0f), 0.0f);
+    ok &= report("fast_asinf", &st_asin);
+
+    printf("%s\n", ok ? "OK" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+/*
+ * 分段速度迭代学习仿真 (Linux 主机)
+ *
+ * 在一个粗糙的小车模型上反复跑 Q2 (直线 - 半圆 - 直线 - 半圆)，
+ * 每圈用固件同一份 LapTimer 记分段成绩、同一份 SpeedLearner_update 修正分段速度，
+ * 打印每圈用时和各段速度，检查学习能收敛到不丢线、圈速变快。
+ *
+ * 模型 (只求趋势，不求定量)：
+ *   占空比 v -> 车速 v * WSL_VMAX_MPS
+ *   循线段 (半圆 R)：位置误差 ≈ k * 向心加速度 v²/R，超过传感器半宽 (5) 丢线；
+ *                    向心加速度超过 1 m/s² 时外环输出顶到限幅
+ *   航向保持段：航向误差 ≈ 4 * v² (°)
+ *   每个控制周期加 ±10% 的伪随机扰动
+ *
+ * 用法: ilc_sim [-n laps] [-k arc_gain]
+ *   -n laps      跑多少圈，默认 40
+ *   -k arc_gain  循线误差系数 k，默认 2.5 (调大模拟更难跑的弯)
+ * 返回 0 = 收敛 (最后 10 圈没有丢线且圈速比第一圈快)，1 = 不收敛
+ */
+#include "LapTimer.hpp"
+#include "SpeedLearner.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+#define SIM_VMAX_MPS   1.20f    // 与 WheelSpeedLoop.hpp 的 WSL_VMAX_MPS 一致
+#define SIM_DT_MS      20U      // 与 LF_CTRL_MS 一致
+#define SIM_LINE_SPAN  5.0f     // 传感器权重半宽，超出即丢线
+#define SIM_SAT_ALAT   1.0f     // m/s²
+
+struct SimSegment {
+    route::Drive drive;
+    float length_m;
+    float radius_m;             // 只对循线段有意义
+};
+
+// Q2 场地：1 m 直线 + 半径 0.4 m 半圆
+static const SimSegment kTrack[] = {
+    {route::Drive::YawHold,    1.0f,              0.0f},
+    {route::Drive::LineFollow, 3.14159f * 0.4f,   0.4f},
+    {route::Drive::YawHold,    1.0f,              0.0f},
+    {route::Drive::LineFollow, 3.14159f * 0.4f,   0.4f},
+    {route::Drive::Stop,       0.0f,              0.0f},
+};
+static constexpr uint8_t kSegCount = sizeof(kTrack) / sizeof(kTrack[0]);
+
+// 固件参数表的默认值
+static constexpr float kSpeedStraight = 0.10f;
+static constexpr float kSpeedArc      = 0.10f;
+static constexpr LearnConfig kConfig{3.0f, 5.0f, 0.2f, 0.02f, 0.85f, 0.08f, 0.60f};
+
+static uint32_t s_rng = 12345;
+static float noise() {
+    s_rng = s_rng * 1103515245U + 12345U;
+    return ((float)((s_rng >> 8) & 0xFFFF) / 65535.0f - 0.5f) * 0.2f;
+}
+
+// 跑一圈，返回用时 (ms)；丢线返回 0
+static uint32_t runLap(LapTimer& timer, const float* speeds, float arc_gain, uint32_t& now) {
+    timer.begin(2, true, now);
+    for (uint8_t i = 0; i < kSegCount; i++) {
+        const SimSegment& seg = kTrack[i];
+        bool terminal = seg.drive == route::Drive::Stop;
+        timer.segment(i, (uint8_t)seg.drive, terminal, now);
+        if (terminal) break;
+
+        float def = seg.drive == route::Drive::LineFollow ? kSpeedArc : kSpeedStraight;
+        float v = (speeds[i] > 0.0f ? speeds[i] : def) * SIM_VMAX_MPS;
+        for (float dist = 0.0f; dist < seg.length_m; dist += v * SIM_DT_MS * 0.001f) {
+            now += SIM_DT_MS;
+            float err;
+            bool sat = false;
+            if (seg.drive == route::Drive::LineFollow) {
+                float alat = v * v / seg.radius_m;
+                err = arc_gain * alat * (1.0f + noise());
+                sat = alat > SIM_SAT_ALAT;
+                if (err > SIM_LINE_SPAN) {
+                    timer.lost(now);
+                    return 0;
+                }
+            } else {
+                err = 4.0f * v * v * (1.0f + noise());
+            }
+            timer.sample(err, sat, SIM_DT_MS);
+        }
+    }
+    return timer.summary(2).last_ms;
+}
+
+int main(int argc, char** argv) {
+    int laps = 40;
+    float arc_gain = 2.5f;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:k:")) != -1) {
+        if (opt == 'n') laps = atoi(optarg);
+        else if (opt == 'k') arc_gain = strtof(optarg, nullptr);
+        else {
+            fprintf(stderr, "usage: %s [-n laps] [-k arc_gain]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (laps < 11) laps = 11;
+
+    LapTimer timer;
+    float speeds[ROUTE_MAX_SEG] = {};
+    uint32_t now = 0;
+    uint32_t first_ms = 0, last_ms = 0;
+    int late_lost = 0;
+
+    printf("lap,ms,lost");
+    for (uint8_t i = 0; i < kSegCount; i++) printf(",v%u", i);
+    printf("\n");
+
+    for (int lap = 1; lap <= laps; lap++) {
+        uint32_t ms = runLap(timer, speeds, arc_gain, now);
+        if (lap == 1) first_ms = ms;
+        if (ms) last_ms = ms;
+        if (!ms && lap > laps - 10) late_lost++;
+
+        SegmentSplit splits[ROUTE_MAX_SEG];
+        uint8_t q;
+        bool aborted;
+        uint8_t n = timer.lastSplits(splits, ROUTE_MAX_SEG, q, aborted);
+        SpeedLearner_update(speeds, splits, n, aborted, kConfig, kSpeedStraight, kSpeedArc);
+
+        printf("%d,%u,%d", lap, ms, ms == 0);
+        for (uint8_t i = 0; i < kSegCount; i++) printf(",%.3f", speeds[i]);
+        printf("\n");
+    }
+
+    bool ok = late_lost == 0 && first_ms > 0 && last_ms > 0 && last_ms < first_ms;
+    fprintf(stderr, "first lap %u ms, last lap %u ms, lost in last 10: %d -> %s\n",
+            first_ms, last_ms, late_lost, ok ? "converged" : "NOT converged");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,9 @@
+#ifndef SEGGER_RTT_H
+#define SEGGER_RTT_H
+
+/* 主机回放：RTT 日志改走 stderr，stdout 只留姿态轨迹 */
+#include <stdio.h>
+
+#define RTT_Log(...)  fprintf(stderr, __VA_ARGS__)
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef __STM32H7xx_HAL_H
+#define __STM32H7xx_HAL_H
+
+/* 主机回放用的 HAL 替身：只提供 IMU 相关源码用到的几个符号 */
+#include <stdint.h>
+
+static inline void HAL_Delay(uint32_t ms) { (void)ms; }
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t primask) { (void)primask; }
+static inline void __disable_irq(void) {}
+
+#endif
@@ -0,0 +1,196 @@
+/*
+ * IMU 回放 / 基准工具 (Linux 主机)
+ *
+ * 把 Drivers/BSP/ICM45686 下的 IMU.c + 姿态滤波后端原样编到主机上，
+ * bsp_IcmGetRawData / bsp_IcmGetMag 换成从录制文件取数据，逐样本调用 IMU_getYawPitchRoll，
+ * 输出 yaw/pitch/roll 轨迹 (stdout, CSV) 和每样本耗时 (stderr)。
+ *
+ * 录制格式 (二者自动识别)：
+ *   CSV   : t_ms,ax,ay,az,gx,gy,gz,temp[,mx,my,mz]   单位 mg / dps / °C / uT，非数字开头的行当表头跳过
+ *   二进制: 8 字节 "IMUREC01" 文件头 + ImuReplayRecord 数组 (小端)
+ *
+ * 用法: imu_replay [-s speed] [-q] [-m] file
+ *   -s speed  按时间戳回放的倍速 (1 = 实时)，默认 0 = 不等待全速跑
+ *   -q        不输出轨迹，只打统计
+ *   -m        磁场参与融合 (录制里的磁场是标定后的值，或 IMU.h 默认值就是本车标定结果时用)；
+ *             固件里要 imu.mag_ok 才融合，回放默认同样退回 6 轴
+ */
+#include "IMU.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define REPLAY_HAVE_TSC 1
+#endif
+
+#define REPLAY_BIN_MAGIC "IMUREC01"
+
+typedef struct {
+    uint32_t t_us;
+    float accel_mg[3];
+    float gyro_dps[3];
+    float temp_degc;
+    float mag_ut[3];       // 全 0 表示该样本没有磁场
+} ImuReplayRecord;
+
+static ImuReplayRecord cur;
+static int cur_has_mag;
+
+/* ---------- 替换 read_aux_data_mode.c 里的硬件接口 ---------- */
+int setup_imu(int use_ln, int accel_en, int gyro_en)
+{
+    (void)use_ln; (void)accel_en; (void)gyro_en;
+    return 0;
+}
+
+int setup_imu_probe(void)
+{
+    return 0;
+}
+
+int setup_imu_config(int use_ln, int accel_en, int gyro_en)
+{
+    (void)use_ln; (void)accel_en; (void)gyro_en;
+    return 0;
+}
+
+int setup_aux_mag(void)
+{
+    return 0;
+}
+
+int bsp_IcmGetRawData(float accel_mg[3], float gyro_dps[3], float *temp_degc)
+{
+    memcpy(accel_mg, cur.accel_mg, sizeof(cur.accel_mg));
+    memcpy(gyro_dps, cur.gyro_dps, sizeof(cur.gyro_dps));
+    *temp_degc = cur.temp_degc;
+    return 0;
+}
+
+int bsp_IcmGetMag(float mag_ut[3])
+{
+    if (!cur_has_mag) return 1;
+    memcpy(mag_ut, cur.mag_ut, sizeof(cur.mag_ut));
+    return 0;
+}
+
+/* ---------- 录制文件读取 ---------- */
+static int is_binary;
+
+static int read_record(FILE * f, ImuReplayRecord * r)
+{
+    if (is_binary)
+        return fread(r, sizeof(*r), 1, f) == 1;
+
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char c = line[0];
+        if (!((c >= '0' && c <= '9') || c == '-' || c == '.'))
+            continue; // 表头 / 空行
+
+        float t_ms;
+        memset(r, 0, sizeof(*r));
+        int n = sscanf(line, "%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f", &t_ms,
+                       &r->accel_mg[0], &r->accel_mg[1], &r->accel_mg[2],
+                       &r->gyro_dps[0], &r->gyro_dps[1], &r->gyro_dps[2], &r->temp_degc,
+                       &r->mag_ut[0], &r->mag_ut[1], &r->mag_ut[2]);
+        if (n < 8) continue;
+        r->t_us = (uint32_t)(t_ms * 1000.0f);
+        return 1;
+    }
+    return 0;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void sleep_until_ns(uint64_t t)
+{
+    uint64_t n = now_ns();
+    if (t <= n) return;
+    struct timespec ts = { (time_t)((t - n) / 1000000000ull), (long)((t - n) % 1000000000ull) };
+    nanosleep(&ts, NULL);
+}
+
+int main(int argc, char ** argv)
+{
+    double speed = 0.0;
+    int quiet = 0;
+    const char * path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) speed = atof(argv[++i]);
+        else if (strcmp(argv[i], "-q") == 0) quiet = 1;
+        else if (strcmp(argv[i], "-m") == 0) mag_calibrated = true;
+        else path = argv[i];
+    }
+    if (!path) {
+        fprintf(stderr, "usage: %s [-s speed] [-q] [-m] recording.(csv|bin)\n", argv[0]);
+        return 2;
+    }
+
+    FILE * f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    char magic[8];
+    is_binary = fread(magic, 1, 8, f) == 8 && memcmp(magic, REPLAY_BIN_MAGIC, 8) == 0;
+    if (!is_binary) rewind(f);
+
+    IMU_init();
+
+    if (!quiet) printf("t_ms,yaw,pitch,roll\n");
+
+    uint64_t samples = 0, ns_total = 0, cyc_total = 0;
+    uint64_t wall0 = now_ns();
+    uint32_t t0_us = 0;
+    float ypr[3] = { 0 }, yaw_first = 0.0f;
+
+    while (read_record(f, &cur)) {
+        cur_has_mag = cur.mag_ut[0] != 0.0f || cur.mag_ut[1] != 0.0f || cur.mag_ut[2] != 0.0f;
+        if (samples == 0) t0_us = cur.t_us;
+        if (speed > 0.0)
+            sleep_until_ns(wall0 + (uint64_t)((double)(cur.t_us - t0_us) * 1000.0 / speed));
+
+        // 计时范围与目标板 TIM7 中断里一致：取数 + 融合 + 解算 yaw
+        uint64_t t_start = now_ns();
+#ifdef REPLAY_HAVE_TSC
+        uint64_t c_start = __rdtsc();
+#endif
+        IMU_getYawPitchRoll(ypr);
+#ifdef REPLAY_HAVE_TSC
+        cyc_total += __rdtsc() - c_start;
+#endif
+        ns_total += now_ns() - t_start;
+
+        IMU_getPitchRoll(&ypr[1]);
+        if (samples == 0) yaw_first = ypr[0];
+        samples++;
+
+        if (!quiet)
+            printf("%.3f,%.4f,%.4f,%.4f\n", cur.t_us / 1000.0, ypr[0], ypr[1], ypr[2]);
+    }
+    fclose(f);
+
+    if (samples == 0) {
+        fprintf(stderr, "no samples in %s\n", path);
+        return 1;
+    }
+    fprintf(stderr, "samples=%llu  span=%.2f s  ns/sample=%.1f",
+            (unsigned long long)samples, (cur.t_us - t0_us) / 1e6, (double)ns_total / samples);
+#ifdef REPLAY_HAVE_TSC
+    fprintf(stderr, "  tsc/sample=%.1f", (double)cyc_total / samples);
+#endif
+    fprintf(stderr, "\nfinal yaw=%.3f pitch=%.3f roll=%.3f  yaw change=%.3f deg\n",
+            ypr[0], ypr[1], ypr[2], ypr[0] - yaw_first);
+    return 0;
+}
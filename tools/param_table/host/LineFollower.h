@@ -0,0 +1,11 @@
+#ifndef LINE_FOLLOWER_H
+#define LINE_FOLLOWER_H
+
+/*
+ * 主机检查用的 LineFollower.h 替身：Params.cpp 只用到两个默认值宏。
+ * 取值与 Drivers/BSP/Inc/LineFollower.h 保持一致 (param_table 会打印默认值，改了那边这里跟着改)
+ */
+#define LF_TURN_D_ALPHA     0.6f
+#define LF_SPEED_LOOP_EN    1
+
+#endif
@@ -0,0 +1,9 @@
+#pragma once
+
+/*
+ * 主机检查用的 PidStorage.hpp 替身：Params.cpp 只用到 PID 编号
+ * (真文件带着 W25Q64 / HAL，和 Drivers/BSP/Inc/PidStorage.hpp 的编号保持一致)
+ */
+#define PID_ID_TURN     0
+#define PID_ID_FORWARD  1
+#define PID_ID_WHEEL    2
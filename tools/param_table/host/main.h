@@ -0,0 +1,19 @@
+#ifndef __MAIN_H
+#define __MAIN_H
+
+/* 主机检查用的 main.h 替身：只提供 SensorArray.hpp 描述线束用到的几个符号 */
+#include <stdint.h>
+
+typedef struct {
+    volatile uint32_t IDR;
+} GPIO_TypeDef;
+
+#define GPIOA_BASE   0x58020000UL
+
+#define GPIO_PIN_8   ((uint16_t)0x0100)
+#define GPIO_PIN_10  ((uint16_t)0x0400)
+#define GPIO_PIN_11  ((uint16_t)0x0800)
+#define GPIO_PIN_12  ((uint16_t)0x1000)
+#define GPIO_PIN_15  ((uint16_t)0x8000)
+
+#endif
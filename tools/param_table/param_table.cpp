@@ -0,0 +1,90 @@
+/*
+ * 参数表主机检查 (Linux 主机)
+ *
+ * Params.cpp 原样参与编译：kParams 的完美哈希是 constexpr 求出来的，找不到无冲突种子时这一步就编译失败。
+ * 编过以后再逐项检查：
+ *   - Param_find(名字) 回到自己的下标，表外的名字返回 -1
+ *   - Flash 用的名字哈希 hash(name, 0) 互不相同 (ParamStorage 按它认领条目)
+ *   - 默认值在 [min, max] 内，步长为正，Param_set 越界会夹紧
+ * 全部通过返回 0，否则 1。-v 打印整张表。
+ */
+#include "Params.hpp"
+#include "LineFollower_Interface.h"
+#include "attitude_filter.h"
+#include "IMU.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// ================== 回调替身 (检查不调用回调) ==================
+float mahony_kp_settled, mahony_ki, madgwick_beta_settled;
+float mag_offset[3] = {IMU_MAG_OFFSET_X, IMU_MAG_OFFSET_Y, IMU_MAG_OFFSET_Z};
+float mag_scale[3] = {IMU_MAG_SCALE_X, IMU_MAG_SCALE_Y, IMU_MAG_SCALE_Z};
+bool mag_calibrated;
+void LineFollower_SetPID(uint8_t, float, float, float) {}
+void LineFollower_SetTurnDAlpha(float) {}
+void LineFollower_SetClosedLoop(bool) {}
+void IMU_retuneFilter(void) {}
+
+static int s_fail = 0;
+
+#define CHECK(cond, ...)                         \
+    do {                                         \
+        if (!(cond)) {                           \
+            fprintf(stderr, "FAIL: " __VA_ARGS__); \
+            fprintf(stderr, "\n");               \
+            s_fail++;                            \
+        }                                        \
+    } while (0)
+
+static float roundFor(const param::Desc& d, float v) {
+    if (d.type == param::Type::Int) return (float)lroundf(v);
+    if (d.type == param::Type::Bool) return v != 0.0f ? 1.0f : 0.0f;
+    return v;
+}
+
+int main(int argc, char** argv) {
+    bool verbose = argc > 1 && std::strcmp(argv[1], "-v") == 0;
+    int n = Param_count();
+    CHECK(n > 0, "empty table");
+
+    for (int i = 0; i < n; i++) {
+        const param::Desc& d = Param_desc(i);
+        CHECK(Param_find(d.name) == i, "%s: Param_find -> %d, expected %d", d.name, Param_find(d.name), i);
+        CHECK(Param_findHash(param::hash(d.name, 0)) == i, "%s: flash hash collides with %s", d.name,
+              Param_desc(Param_findHash(param::hash(d.name, 0))).name);
+        CHECK(d.min <= d.def && d.def <= d.max, "%s: default %g outside [%g, %g]", d.name, d.def, d.min, d.max);
+        CHECK(d.step > 0.0f, "%s: step must be positive", d.name);
+        CHECK(d.ptr != nullptr, "%s: no variable", d.name);
+    }
+
+    // 上电时静态初始化已写过默认值
+    for (int i = 0; i < n; i++) {
+        const param::Desc& d = Param_desc(i);
+        CHECK(Param_get(i) == roundFor(d, d.def), "%s: value %g after reset, default %g", d.name, Param_get(i), d.def);
+        if (verbose) {
+            printf("%-16s %-5s [%g, %g] def=%g step=%g%s\n", d.name,
+                   d.type == param::Type::Float ? "float" : (d.type == param::Type::Int ? "int" : "bool"),
+                   d.min, d.max, d.def, d.step, (d.flags & param::Persist) ? " persist" : "");
+        }
+    }
+
+    // 越界夹紧，然后恢复默认
+    for (int i = 0; i < n; i++) {
+        const param::Desc& d = Param_desc(i);
+        Param_set(i, d.max + 1000.0f, false);
+        CHECK(Param_get(i) == roundFor(d, d.max), "%s: not clamped to max", d.name);
+        Param_set(i, d.min - 1000.0f, false);
+        CHECK(Param_get(i) == roundFor(d, d.min), "%s: not clamped to min", d.name);
+        Param_set(i, NAN, false);
+        CHECK(Param_get(i) == roundFor(d, d.min), "%s: NaN not clamped to min", d.name);
+    }
+    Param_resetDefaults();
+
+    const char* missing[] = {"", "lpid", "lpid.pp", "LPID.P", "speed", "nope.nope"};
+    for (const char* name : missing) CHECK(Param_find(name) == -1, "\"%s\" should not be found", name);
+
+    printf("%d params, %s\n", n, s_fail ? "FAILED" : "OK");
+    return s_fail ? 1 : 0;
+}
@@ -0,0 +1,7 @@
+#ifndef __MAIN_H
+#define __MAIN_H
+
+/* 主机测试用的 main.h 替身：主机上没有 __ARM_FEATURE_DSP，PidFixed.hpp 只走 C 实现，不需要任何 CMSIS 符号 */
+#include <stdint.h>
+
+#endif
@@ -0,0 +1,136 @@
+/*
+ * 定点 PID 主机测试 (Linux 主机)
+ *
+ * 主机上没有 __ARM_FEATURE_DSP，PidFixed.hpp 的 __SSAT / __QADD / __QSUB / __SMLAD 全部退回 qmath 的 C 实现：
+ *   1. 先在边界值上把这几个 C 实现和按定义 (int64 计算再饱和) 的结果逐个比对
+ *   2. 再把同一组输入分别喂给 PidController<float> / <Q31> / <Q15>，逐拍比较输出
+ *
+ * 输入序列 (开环给定 设定值 / 测量值)：
+ *   阶跃   设定值 0 -> 0.4，测量值一阶跟随
+ *   斜坡   设定值 0 -> 0.8 匀速爬升，测量值滞后 10 拍
+ *   饱和   误差 0.9 把输出 (kp * e = 1.35) 顶到上限、积分顶到限幅，再反向，最后回到小误差看退饱和
+ *          (误差本身要在 Q 格式的 [-1, 1) 内：定点版本会把超出的误差先饱和，那是表示范围的差别，不是实现的差别)
+ *   保持   同 "饱和"，但按 float 版本上一拍输出是否到限幅给 hold_integral (三个控制器用同一个标志)
+ *   积分   恒定误差 0.2 跑 400 拍，ki = 1/128 远小于 1、积分限幅 50：误差和要积到 50 (远超 1.0) 才被夹住，
+ *          I 项从 0 爬到 0.39，定点版本的累加量和限幅都不能卡在 1.0
+ *
+ * 容差：Q31 增益为 Q27，误差只剩 float 自身的舍入；Q15 增益为 Q11 (ki = 0.01 量化成 0.00977)，
+ *       积分顶满时 I 项就差 2.4e-4，再加 P/D 项和输出的 LSB。
+ *
+ * 用法: pid_fixed [-v]
+ *   -v  逐拍打印 序列名, k, float, Q31, Q15
+ * 返回 0 = 全部在容差内，1 = 超差
+ */
+#include "PidFixed.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#define TOL_Q31  1e-5f
+#define TOL_Q15  1e-3f
+
+static bool verbose = false;
+
+// ---------------- qmath C 实现 ----------------
+static int64_t sat(int64_t x, int64_t lo, int64_t hi) { return x < lo ? lo : (x > hi ? hi : x); }
+
+static bool checkQmath() {
+    static const int32_t v32[] = {INT32_MIN, INT32_MIN + 1, -65536, -32769, -32768, -1, 0, 1,
+                                  32767, 32768, 65535, INT32_MAX - 1, INT32_MAX};
+    static const int32_t v16[] = {INT16_MIN, INT16_MIN + 1, -12345, -1, 0, 1, 12345, INT16_MAX - 1, INT16_MAX};
+    int fails = 0;
+
+    for (int32_t a : v32) {
+        if (qmath::ssat16(a) != sat(a, INT16_MIN, INT16_MAX)) fails++;
+        for (int32_t b : v32) {
+            if (qmath::qadd(a, b) != sat((int64_t)a + b, INT32_MIN, INT32_MAX)) fails++;
+            if (qmath::qsub(a, b) != sat((int64_t)a - b, INT32_MIN, INT32_MAX)) fails++;
+        }
+        if (qmath::sat32((int64_t)a * 4) != sat((int64_t)a * 4, INT32_MIN, INT32_MAX)) fails++;
+    }
+    // SMLAD 不饱和 (两个 16x16 乘积之和最大 2^31，只在 -32768 * -32768 * 2 时回绕，和硬件一致)
+    for (int32_t xl : v16) for (int32_t xh : v16) for (int32_t yl : v16) for (int32_t yh : v16) {
+        int32_t acc = 1000;
+        int64_t ref = (int64_t)acc + (int64_t)xl * yl + (int64_t)xh * yh;
+        int32_t got = qmath::smlad(qmath::pack16(xl, xh), qmath::pack16(yl, yh), acc);
+        if (got != (int32_t)(uint32_t)ref) fails++;
+    }
+
+    printf("qmath  %s  (%d 处不一致)\n", fails ? "FAIL" : "ok  ", fails);
+    return fails == 0;
+}
+
+// ---------------- 定点 / 浮点 PID 对照 ----------------
+struct Seq {
+    const char* name;
+    std::vector<float> sp, meas;
+    bool hold;   // 输出到限幅后下一拍不积分
+};
+
+static bool runSeq(const Seq& s, float kp, float ki, float kd, float i_lim) {
+    PidController<float> pf(kp, ki, kd, -1.0f, 1.0f);
+    PidController<Q31> p31(kp, ki, kd, Q31::fromFloat(-1.0f), Q31::fromFloat(1.0f));
+    PidController<Q15> p15(kp, ki, kd, Q15::fromFloat(-1.0f), Q15::fromFloat(1.0f));
+    pf.setIntegralLimit(i_lim);
+    p31.setIntegralLimit(i_lim);
+    p15.setIntegralLimit(i_lim);
+
+    float err31 = 0.0f, err15 = 0.0f;
+    int saturated = 0;
+    bool hold = false;
+    for (size_t k = 0; k < s.sp.size(); k++) {
+        float f = pf.compute(s.sp[k], s.meas[k], hold);
+        float o31 = p31.compute(Q31::fromFloat(s.sp[k]), Q31::fromFloat(s.meas[k]), hold).toFloat();
+        float o15 = p15.compute(Q15::fromFloat(s.sp[k]), Q15::fromFloat(s.meas[k]), hold).toFloat();
+        if (verbose) printf("%s,%zu,%.6f,%.6f,%.6f\n", s.name, k, f, o31, o15);
+
+        err31 = fmaxf(err31, fabsf(o31 - f));
+        err15 = fmaxf(err15, fabsf(o15 - f));
+        if (fabsf(f) >= 1.0f) saturated++;
+        hold = s.hold && fabsf(f) >= 1.0f;
+    }
+
+    bool ok = err31 <= TOL_Q31 && err15 <= TOL_Q15;
+    printf("%-6s %s  (max |diff| Q31=%.2e Q15=%.2e，%d 拍饱和)\n", s.name, ok ? "ok  " : "FAIL", err31, err15, saturated);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "-v") == 0) verbose = true;
+
+    const int N = 400;
+    Seq step{"阶跃", {}, {}, false}, ramp{"斜坡", {}, {}, false}, satur{"饱和", {}, {}, false};
+    Seq integ{"积分", {}, {}, false};
+    for (int k = 0; k < N; k++) {
+        float sp = k < 20 ? 0.0f : 0.4f;
+        step.sp.push_back(sp);
+        step.meas.push_back(k < 20 ? 0.0f : 0.4f * (1.0f - expf(-(float)(k - 20) / 30.0f)));
+
+        auto r = [](int i) { return i <= 0 ? 0.0f : (i >= 200 ? 0.8f : 0.8f * (float)i / 200.0f); };
+        ramp.sp.push_back(r(k));
+        ramp.meas.push_back(r(k - 10));
+
+        // 前 150 拍正向顶满，之后反向顶满，最后 100 拍回到小误差看退饱和
+        if (k < 150)      { satur.sp.push_back(0.45f);  satur.meas.push_back(-0.45f); }
+        else if (k < 300) { satur.sp.push_back(-0.45f); satur.meas.push_back(0.45f); }
+        else              { satur.sp.push_back(0.1f);  satur.meas.push_back(0.05f); }
+
+        integ.sp.push_back(0.2f);
+        integ.meas.push_back(0.0f);
+    }
+
+    bool ok = checkQmath();
+    ok &= runSeq(step, 1.5f, 0.01f, 0.3f, 0.999f);
+    ok &= runSeq(ramp, 1.5f, 0.01f, 0.3f, 0.999f);
+    ok &= runSeq(satur, 1.5f, 0.01f, 0.3f, 0.999f);
+    Seq held = satur;
+    held.name = "保持";
+    held.hold = true;
+    ok &= runSeq(held, 1.5f, 0.01f, 0.3f, 0.999f);
+    ok &= runSeq(integ, 0.5f, 1.0f / 128.0f, 0.0f, 50.0f);   // ki 取 Q11 能精确表示的值，只比累加量
+
+    printf("%s\n", ok ? "OK" : "FAIL");
+    return ok ? 0 : 1;
+}